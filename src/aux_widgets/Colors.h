@@ -49,6 +49,9 @@ static const QColor graphDetached(133, 30, 62); //#851E3E
 static const QColor graphTag(222, 195, 195); //#DEC3C3
 static const QColor highlightCommentStart(64, 65, 66); //#404142
 static const QColor highlightCommentEnd(96, 97, 98); //#606162
+static const QColor blameSeparatorColor(96, 97, 98); //#606162
+static const QColor blameNumberBorderColor(32, 33, 34); //#202122
+static const QColor blameInfoBackgroundColorBright(198, 198, 199); //#C6C6C7
 static const QColor jenkinsResultSuccess(0, 175, 24); //#00AF18
 static const QColor jenkinsResultFailure(193, 32, 32); //#C12020
 static const QColor jenkinsResultAborted(91, 91, 91); //#5B5B5B
@@ -42,7 +42,7 @@ SquashDlg::SquashDlg(const QSharedPointer<GitBase> git, const QSharedPointer<Git
    for (const auto &sha : shas)
    {
       const auto shortSha = sha.left(8);
-      const auto commitTitle = mCache->commitInfo(sha).shortLog;
+      const auto commitTitle = mCache->commitShortLog(sha);
       description.append(QString("Commit %1: %2 - %3\n\n").arg(row + 1).arg(shortSha, commitTitle));
 
       commitsLayout->addWidget(new QLabel(QString("<strong>(%1)</strong>").arg(shortSha)), row, 0);
@@ -95,7 +95,7 @@ void SquashDlg::accept()
 
             // Create auxiliary branch for rebase
             const auto auxBranch1 = QUuid::createUuid().toString();
-            const auto commitOfAuxBranch1 = lastChild.getFirstChildSha();
+            const auto commitOfAuxBranch1 = mCache->commitSha(lastChild.getFirstChildRow());
             gitBranches->createBranchAtCommit(commitOfAuxBranch1, auxBranch1);
 
             // Create auxiliary branch for merge squash
@@ -6,11 +6,14 @@
 #include <CommitHistoryView.h>
 #include <CommitInfo.h>
 #include <FileBlameWidget.h>
+#include <GitCache.h>
 #include <GitHistory.h>
 #include <RepositoryViewDelegate.h>
 
+#include <QAbstractProxyModel>
 #include <QApplication>
 #include <QClipboard>
+#include <QDir>
 #include <QFileSystemModel>
 #include <QGridLayout>
 #include <QHeaderView>
@@ -36,7 +39,7 @@ BlameWidget::BlameWidget(const QSharedPointer<GitCache> &cache, const QSharedPoi
    mRepoView->header()->setSectionHidden(static_cast<int>(CommitHistoryColumns::Graph), true);
    mRepoView->header()->setSectionHidden(static_cast<int>(CommitHistoryColumns::Date), true);
    mRepoView->header()->setSectionHidden(static_cast<int>(CommitHistoryColumns::Author), true);
-   mRepoView->setItemDelegate(mItemDelegate = new RepositoryViewDelegate(cache, mGit, nullptr, mRepoView));
+   mRepoView->setItemDelegate(mItemDelegate = new RepositoryViewDelegate(cache, nullptr, mRepoView));
    mRepoView->setEnabled(true);
    mRepoView->setMaximumWidth(450);
    mRepoView->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -106,29 +109,8 @@ void BlameWidget::showFileHistory(const QString &filePath)
 {
    if (!mTabsMap.contains(filePath))
    {
-      QScopedPointer<GitHistory> git(new GitHistory(mGit));
-      auto ret = git->history(filePath);
-
-      if (ret.success)
+      if (const auto shaHistory = fileHistory(filePath); !shaHistory.isEmpty())
       {
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-         auto shaHistory = ret.output.split("\n", Qt::SkipEmptyParts);
-#else
-         auto shaHistory = ret.output.split("\n", QString::SkipEmptyParts);
-#endif
-         for (auto i = 0; i < shaHistory.size();)
-         {
-            if (shaHistory.at(i).startsWith("gpg:"))
-            {
-               shaHistory.takeAt(i);
-
-               if (shaHistory.size() <= i)
-                  break;
-            }
-            else
-               ++i;
-         }
-
          mRepoView->blockSignals(true);
          mRepoView->filterBySha(shaHistory);
          mRepoView->blockSignals(false);
@@ -153,6 +135,46 @@ void BlameWidget::showFileHistory(const QString &filePath)
       mTabWidget->setCurrentWidget(mTabsMap.value(filePath));
 }
 
+QStringList BlameWidget::fileHistory(const QString &filePath) const
+{
+   // The paths indexed are relative to the root of the repository.
+   const auto relativePath
+       = QDir::isRelativePath(filePath) ? filePath : QDir(mGit->getWorkingDir()).relativeFilePath(filePath);
+
+   // Only the loaded commits are taken from the index: a limited history would miss the older ones.
+   if (!mCache->isHistoryTruncated())
+   {
+      if (const auto shas = mCache->pathHistory(relativePath))
+         return shas.value();
+   }
+
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+   const auto ret = git->history(filePath);
+
+   if (!ret.success)
+      return QStringList();
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   auto shaHistory = ret.output.split("\n", Qt::SkipEmptyParts);
+#else
+   auto shaHistory = ret.output.split("\n", QString::SkipEmptyParts);
+#endif
+   for (auto i = 0; i < shaHistory.size();)
+   {
+      if (shaHistory.at(i).startsWith("gpg:"))
+      {
+         shaHistory.takeAt(i);
+
+         if (shaHistory.size() <= i)
+            break;
+      }
+      else
+         ++i;
+   }
+
+   return shaHistory;
+}
+
 void BlameWidget::onNewRevisions(int totalCommits)
 {
    mRepoModel->onNewRevisions(totalCommits);
@@ -183,39 +205,20 @@ void BlameWidget::reloadHistory(int tabIndex)
       const auto sha = blameWidget->getCurrentSha();
       const auto file = blameWidget->getCurrentFile();
 
-      QScopedPointer<GitHistory> git(new GitHistory(mGit));
-      const auto ret = git->history(file);
-
-      if (ret.success)
+      if (const auto shaHistory = fileHistory(file); !shaHistory.isEmpty())
       {
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-         auto shaHistory = ret.output.split("\n", Qt::SkipEmptyParts);
-#else
-         auto shaHistory = ret.output.split("\n", QString::SkipEmptyParts);
-#endif
-         for (auto i = 0; i < shaHistory.size();)
-         {
-            if (shaHistory.at(i).startsWith("gpg:"))
-            {
-               shaHistory.takeAt(i);
-
-               if (shaHistory.size() <= i)
-                  break;
-            }
-            else
-               ++i;
-         }
-
          mRepoView->blockSignals(true);
          mRepoView->filterBySha(shaHistory);
 
-         const auto repoModel = mRepoView->model();
-         const auto totalRows = repoModel->rowCount();
-         for (auto i = 0; i < totalRows; ++i)
+         // The filter maps the row of the commit in the cache directly, without reading the SHA of every row.
+         const auto proxyModel = qobject_cast<QAbstractProxyModel *>(mRepoView->model());
+
+         if (const auto commit = mCache->commitInfo(sha); proxyModel && commit.isValid())
          {
-            const auto index = mRepoView->model()->index(i, static_cast<int>(CommitHistoryColumns::Sha));
+            const auto sourceIndex
+                = proxyModel->sourceModel()->index(commit.pos, static_cast<int>(CommitHistoryColumns::Sha));
 
-            if (index.data().toString().startsWith(sha))
+            if (const auto index = proxyModel->mapFromSource(sourceIndex); index.isValid())
             {
                mRepoView->setCurrentIndex(index);
                mRepoView->selectionModel()->select(index,
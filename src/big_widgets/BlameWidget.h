@@ -131,6 +131,14 @@ private:
     * @param index The index from the file system model.
     */
    void showFileHistoryByIndex(const QModelIndex &index);
+   /**
+    * @brief Returns the commits that changed the file, newest first. They are taken from the index of the changed paths
+    * of the cache. Git is only asked while the index is not built yet or when the history loaded is limited.
+    *
+    * @param filePath The path of the file.
+    * @return The SHAs of the commits.
+    */
+   QStringList fileHistory(const QString &filePath) const;
    /**
     * @brief Shows the context menu for the history view.
     *
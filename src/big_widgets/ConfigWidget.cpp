@@ -1,6 +1,7 @@
 #include "ConfigWidget.h"
 #include "ui_ConfigWidget.h"
 
+#include <AGitProcess.h>
 #include <FileEditor.h>
 #include <GitBase.h>
 #include <GitQlientSettings.h>
@@ -279,6 +280,7 @@ void ConfigWidget::saveConfig()
    settings.setGlobalValue("FileDiffView/FontSize", ui->sbEditorFontSize->value());
    settings.setGlobalValue("colorSchema", ui->cbStyle->currentText());
    settings.setGlobalValue("gitLocation", ui->leGitPath->text());
+   AGitProcess::resetGitLocation();
 
    mLocalGit->changeFontSize();
    mGlobalGit->changeFontSize();
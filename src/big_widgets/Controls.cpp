@@ -337,10 +337,8 @@ void Controls::pushCurrentBranch()
          const auto oldSha = mCache->getShaOfReference(QString("%1/%2").arg(remote.output, currentBranch),
                                                        References::Type::RemoteBranches);
          const auto sha = mCache->getShaOfReference(currentBranch, References::Type::LocalBranch);
-         mCache->deleteReference(oldSha, References::Type::RemoteBranches,
-                                 QString("%1/%2").arg(remote.output, currentBranch));
-         mCache->insertReference(sha, References::Type::RemoteBranches,
-                                 QString("%1/%2").arg(remote.output, currentBranch));
+         mCache->moveReference(oldSha, sha, References::Type::RemoteBranches,
+                               QString("%1/%2").arg(remote.output, currentBranch));
          emit mCache->signalCacheUpdated();
          emit signalRefreshPRsCache();
       }
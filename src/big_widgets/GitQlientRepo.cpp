@@ -18,6 +18,7 @@
 #include <GitMerge.h>
 #include <GitQlientSettings.h>
 #include <GitRepoLoader.h>
+#include <GitRepoWatcher.h>
 #include <GitServerCache.h>
 #include <GitServerWidget.h>
 #include <GitSubmodules.h>
@@ -60,11 +61,7 @@ GitQlientRepo::GitQlientRepo(const QSharedPointer<GitBase> &git, const QSharedPo
    , mJenkins(new JenkinsWidget(mGitBase->getGitDir()))
    , mConfigWidget(new ConfigWidget(mGitBase))
    , mAutoFetch(new QTimer())
-<<<<<<< HEAD
-   , mAutoFilesUpdate(new QTimer())
-=======
-   , mGitTags(new GitTags(mGitBase, mGitQlientCache))
->>>>>>> Reload the repositories with application focus
+   , mWatcher(new GitRepoWatcher(mGitBase, this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
@@ -112,6 +109,9 @@ GitQlientRepo::GitQlientRepo(const QSharedPointer<GitBase> &git, const QSharedPo
 
    connect(mAutoFetch, &QTimer::timeout, mControls, &Controls::fetchAll);
 
+   connect(mWatcher, &GitRepoWatcher::referencesChanged, mGitLoader.data(), &GitRepoLoader::loadIncremental);
+   connect(mWatcher, &GitRepoWatcher::workingTreeChanged, this, &GitQlientRepo::updateUiFromWatcher);
+
    connect(mControls, &Controls::requestFullReload, this, &GitQlientRepo::fullReload);
    connect(mControls, &Controls::requestReferencesReload, this, &GitQlientRepo::referencesReload);
 
@@ -173,6 +173,10 @@ GitQlientRepo::GitQlientRepo(const QSharedPointer<GitBase> &git, const QSharedPo
 
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::createProgressDialog);
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingFinished, this, &GitQlientRepo::onRepoLoadFinished);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsBatchLoaded, this,
+           &GitQlientRepo::onRevisionsBatchLoaded);
+   connect(mGitLoader.data(), &GitRepoLoader::signalIncrementalLoadFinished, this,
+           &GitQlientRepo::onIncrementalLoadFinished);
 
    m_loaderThread = new QThread();
    mGitLoader->moveToThread(m_loaderThread);
@@ -287,6 +291,8 @@ void GitQlientRepo::onRepoLoadFinished(bool fullReload)
 
       mControls->enableButtons(true);
 
+      mWatcher->start();
+
       QScopedPointer<GitConfig> git(new GitConfig(mGitBase));
 
       if (!git->getGlobalUserInfo().isValid() && !git->getLocalUserInfo().isValid())
@@ -306,7 +312,14 @@ void GitQlientRepo::onRepoLoadFinished(bool fullReload)
    const auto totalCommits = mGitQlientCache->commitCount();
 
    mHistoryWidget->loadBranches(fullReload);
-   mHistoryWidget->updateGraphView(totalCommits);
+
+   if (mStreamingLoad)
+   {
+      mStreamingLoad = false;
+      mHistoryWidget->appendGraphRows(totalCommits);
+   }
+   else
+      mHistoryWidget->updateGraphView(totalCommits);
 
    mBlameWidget->onNewRevisions(totalCommits);
 
@@ -336,6 +349,42 @@ void GitQlientRepo::onRepoLoadFinished(bool fullReload)
    emit currentBranchChanged();
 }
 
+void GitQlientRepo::onRevisionsBatchLoaded(int totalCommits, bool firstBatch)
+{
+   if (firstBatch)
+   {
+      mStreamingLoad = true;
+
+      mHistoryWidget->setEnabled(true);
+      mHistoryWidget->updateGraphView(totalCommits);
+
+      if (mWaitDlg)
+         mWaitDlg->close();
+   }
+   else if (mStreamingLoad)
+      mHistoryWidget->appendGraphRows(totalCommits);
+}
+
+void GitQlientRepo::onIncrementalLoadFinished(int newCommits, int changedRows, bool referencesChanged)
+{
+   QLog_Info("UI", QString("Incremental load finished with {%1} new commits.").arg(newCommits));
+
+   if (changedRows > 0)
+      mHistoryWidget->insertGraphRows(newCommits, changedRows);
+
+   if (newCommits > 0)
+      mBlameWidget->onNewRevisions(mGitQlientCache->commitCount());
+
+   if (referencesChanged)
+      mHistoryWidget->loadBranches(true);
+
+   mHistoryWidget->updateUiFromWatcher();
+
+   mDiffWidget->reload();
+
+   emit currentBranchChanged();
+}
+
 void GitQlientRepo::loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file,
                                  bool isCached)
 {
@@ -40,6 +40,7 @@ class BlameWidget;
 class MergeWidget;
 class GitServerWidget;
 class QTimer;
+class GitRepoWatcher;
 class WaitingDlg;
 class GitServerCache;
 class GitTags;
@@ -161,13 +162,14 @@ private:
    Jenkins::JenkinsWidget *mJenkins = nullptr;
    ConfigWidget *mConfigWidget = nullptr;
    QTimer *mAutoFetch = nullptr;
-   QTimer *mAutoFilesUpdate = nullptr;
+   GitRepoWatcher *mWatcher = nullptr;
    QTimer *mAutoPrUpdater = nullptr;
    QPointer<WaitingDlg> mWaitDlg;
    QPair<ControlsMainViews, QWidget *> mPreviousView;
    QSharedPointer<GitServer::IRestApi> mApi;
 
    bool mIsInit = false;
+   bool mStreamingLoad = false;
    QThread *m_loaderThread;
 
    /*!
@@ -220,6 +222,22 @@ private:
     * @param fullReload Indicates that the load finished in the full mode (commits + references).
     */
    void onRepoLoadFinished(bool fullReload);
+
+   /**
+    * @brief onRevisionsBatchLoaded Shows the commits that are already in the cache while the log is still loading.
+    * @param totalCommits The total of commits available in the cache.
+    * @param firstBatch True if it is the first batch of the current load.
+    */
+   void onRevisionsBatchLoaded(int totalCommits, bool firstBatch);
+
+   /**
+    * @brief onIncrementalLoadFinished Inserts the new commits in the graph and refreshes the UI after an incremental
+    * load.
+    * @param newCommits The number of commits inserted on top of the history.
+    * @param changedRows The number of rows on top of the history whose graph changed.
+    * @param referencesChanged True if the references were reloaded, otherwise false.
+    */
+   void onIncrementalLoadFinished(int newCommits, int changedRows, bool referencesChanged);
    /*!
     \brief Loads the view to show the diff of a specific file.
 
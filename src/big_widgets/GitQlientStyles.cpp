@@ -75,6 +75,24 @@ QColor GitQlientStyles::getTabColor()
    return colorSchema == "dark" ? graphHoverColorDark : graphBackgroundColorBright;
 }
 
+QColor GitQlientStyles::getBlameInfoBackgroundColor()
+{
+   const auto colorSchema = GitQlientSettings().globalValue("colorSchema", "dark").toString();
+
+   return colorSchema == "dark" ? graphBackgroundColorDark : blameInfoBackgroundColorBright;
+}
+
+QColor GitQlientStyles::getBlameSeparatorColor()
+{
+   // Both schemas use the same color.
+   return blameSeparatorColor;
+}
+
+QColor GitQlientStyles::getBlameNumberBorderColor()
+{
+   return blameNumberBorderColor;
+}
+
 QColor GitQlientStyles::getBlue()
 {
    const auto colorSchema = GitQlientSettings().globalValue("colorSchema", "dark").toString();
@@ -85,6 +85,24 @@ public:
     */
    static QColor getTabColor();
 
+   /**
+    * @brief Gets the background color of the blame columns with the commit information and the line numbers
+    * @return QColor Current blame information background color
+    */
+   static QColor getBlameInfoBackgroundColor();
+
+   /**
+    * @brief Gets the color of the line between the blocks of the blame
+    * @return QColor Current blame separator color
+    */
+   static QColor getBlameSeparatorColor();
+
+   /**
+    * @brief Gets the color of the border between the line numbers and the code of the blame
+    * @return QColor Current blame number border color
+    */
+   static QColor getBlameNumberBorderColor();
+
    /*!
     \brief Gets the GitQlient blue color.
 
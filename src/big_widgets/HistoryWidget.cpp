@@ -3,6 +3,7 @@
 #include <AmendWidget.h>
 #include <BranchesWidget.h>
 #include <CheckBox.h>
+#include <CommitHistoryColumns.h>
 #include <CommitHistoryModel.h>
 #include <CommitHistoryView.h>
 #include <CommitInfo.h>
@@ -37,9 +38,13 @@
 #include <QScreen>
 #include <QSplitter>
 #include <QStackedWidget>
+#include <QTimer>
 
 using namespace QLogger;
 
+static const int FILTER_DELAY_MS = 250;
+static const int MIN_FILTER_LENGTH = 3;
+
 HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> git,
                              const QSharedPointer<GitServerCache> &gitServerCache,
                              const QSharedPointer<GitQlientSettings> &settings, QWidget *parent)
@@ -120,9 +125,21 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
 
    mSearchInput = new QLineEdit();
    mSearchInput->setObjectName("SearchInput");
-   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or log message..."));
+   mSearchInput->setPlaceholderText(tr("Search by SHA, log message or author..."));
    connect(mSearchInput, &QLineEdit::returnPressed, this, &HistoryWidget::search);
 
+   // The history is filtered once the user stops typing.
+   mFilterTimer = new QTimer(this);
+   mFilterTimer->setSingleShot(true);
+   mFilterTimer->setInterval(FILTER_DELAY_MS);
+   connect(mFilterTimer, &QTimer::timeout, this, &HistoryWidget::filterHistory);
+   connect(mSearchInput, &QLineEdit::textChanged, this, [this]() { mFilterTimer->start(); });
+   connect(mCache.get(), &GitCache::searchIndexReady, this, &HistoryWidget::filterHistory);
+   connect(mCache.get(), &GitCache::changedPathsReady, this, [this]() {
+      if (mChFilterByPath->isChecked())
+         filterHistory();
+   });
+
    mRepositoryModel = new CommitHistoryModel(mCache, mGit, mGitServerCache);
    mRepositoryView = new CommitHistoryView(mCache, mGit, mSettings, mGitServerCache);
 
@@ -148,7 +165,7 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
    mRepositoryView->setObjectName("historyGraphView");
    mRepositoryView->setModel(mRepositoryModel);
    mRepositoryView->setItemDelegate(mItemDelegate
-                                    = new RepositoryViewDelegate(cache, mGit, mGitServerCache, mRepositoryView));
+                                    = new RepositoryViewDelegate(cache, mGitServerCache, mRepositoryView));
    mRepositoryView->setEnabled(true);
 
    mBranchesWidget = new BranchesWidget(mCache, mGit);
@@ -176,10 +193,19 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
    mChShowAllBranches->setChecked(mSettings->localValue("ShowAllBranches", true).toBool());
    connect(mChShowAllBranches, &CheckBox::toggled, this, &HistoryWidget::onShowAllUpdated);
 
+   mChFilterByPath = new CheckBox(tr("Filter by path"));
+   mChFilterByPath->setToolTip(tr("Shows only the commits that changed the file or folder of the search"));
+   connect(mChFilterByPath, &CheckBox::toggled, this, [this](bool checked) {
+      mSearchInput->setPlaceholderText(checked ? tr("Filter by file or folder path...")
+                                               : tr("Search by SHA, log message or author..."));
+      filterHistory();
+   });
+
    const auto graphOptionsLayout = new QHBoxLayout();
    graphOptionsLayout->setContentsMargins(QMargins());
    graphOptionsLayout->setSpacing(10);
    graphOptionsLayout->addWidget(mSearchInput);
+   graphOptionsLayout->addWidget(mChFilterByPath);
    graphOptionsLayout->addWidget(cherryPickBtn);
    graphOptionsLayout->addWidget(mChShowAllBranches);
 
@@ -307,6 +333,19 @@ void HistoryWidget::updateGraphView(int totalCommits)
        QItemSelectionModel::Select);
 }
 
+void HistoryWidget::appendGraphRows(int totalCommits)
+{
+   mRepositoryModel->onRevisionsAppended(totalCommits);
+}
+
+void HistoryWidget::insertGraphRows(int newCommits, int changedRows)
+{
+   mRepositoryModel->onRevisionsInserted(1, newCommits, changedRows);
+
+   if (mRepositoryView->hasActiveFilter())
+      mFilterTimer->start();
+}
+
 void HistoryWidget::keyPressEvent(QKeyEvent *event)
 {
    if (event->key() == Qt::Key_Shift)
@@ -385,12 +424,33 @@ void HistoryWidget::onPanelsVisibilityChanged()
 
 void HistoryWidget::search()
 {
-   if (const auto text = mSearchInput->text(); !text.isEmpty())
+   if (mFilterTimer->isActive())
+   {
+      mFilterTimer->stop();
+      filterHistory();
+   }
+
+   if (const auto text = mSearchInput->text(); !text.isEmpty() && mRepositoryView->hasActiveFilter())
+   {
+      // The history only shows the results: Enter goes through them from the best match.
+      if (mSearchResults.isEmpty())
+         QMessageBox::information(this, tr("Not found!"), tr("No commits where found based on the search text."));
+      else
+      {
+         const auto count = mSearchResults.count();
+         const auto current = mSearchResults.indexOf(mRepositoryView->getCurrentSha());
+         const auto next = current == -1 ? 0 : (current + (mReverseSearch ? count - 1 : 1)) % count;
+
+         goToSha(mSearchResults.at(next));
+      }
+   }
+   else if (!text.isEmpty())
    {
-      auto commitInfo = mCache->commitInfo(text);
+      CommitInfo commitInfo;
 
-      if (commitInfo.isValid())
-         goToSha(text);
+      // An ambiguous SHA is searched as text so every search jumps to the next commit that starts with it.
+      if (mCache->findCommit(text, commitInfo) == ShaIndex::MatchType::Unique)
+         goToSha(commitInfo.sha);
       else
       {
          auto selectedItems = mRepositoryView->selectedIndexes();
@@ -413,6 +473,48 @@ void HistoryWidget::search()
    }
 }
 
+void HistoryWidget::filterHistory()
+{
+   const auto text = mSearchInput->text().trimmed();
+   const auto filterByPath = mChFilterByPath->isChecked();
+
+   // Paths are matched exactly, so even a short folder name is a valid filter.
+   if (text.length() < (filterByPath ? 1 : MIN_FILTER_LENGTH))
+   {
+      mSearchResults.clear();
+
+      if (mRepositoryView->hasActiveFilter())
+      {
+         const auto currentSha = mRepositoryView->getCurrentSha();
+
+         mRepositoryView->clearFilter();
+
+         if (!currentSha.isEmpty())
+            mRepositoryView->focusOnCommit(currentSha);
+      }
+   }
+   else if (filterByPath)
+   {
+      // Nothing is filtered until the index of the changed paths is built. It triggers the filter again once ready.
+      if (const auto results = mCache->pathHistory(text))
+      {
+         QLog_Debug("UI", QString("Filtering the history with {%1} commits for the path {%2}.")
+                              .arg(results->count())
+                              .arg(text));
+
+         mSearchResults = results.value();
+         mRepositoryView->filterBySha(mSearchResults);
+      }
+   }
+   else if (const auto results = mCache->searchCommits(text))
+   {
+      QLog_Debug("UI", QString("Filtering the history with {%1} results for {%2}.").arg(results->count()).arg(text));
+
+      mSearchResults = results.value();
+      mRepositoryView->filterBySha(mSearchResults);
+   }
+}
+
 void HistoryWidget::goToSha(const QString &sha)
 {
    mRepositoryView->focusOnCommit(sha);
@@ -422,7 +524,9 @@ void HistoryWidget::goToSha(const QString &sha)
 
 void HistoryWidget::commitSelected(const QModelIndex &index)
 {
-   const auto sha = mRepositoryModel->sha(index.row());
+   // The index can belong to the filter of the view instead of the model.
+   const auto sha
+       = mRepositoryView->model()->index(index.row(), static_cast<int>(CommitHistoryColumns::Sha)).data().toString();
 
    selectCommit(sha);
 }
@@ -549,8 +653,8 @@ void HistoryWidget::cherryPickCommit()
          commit.sha = mGit->getLastCommit().output.trimmed();
 
          mCache->insertCommit(commit);
-         mCache->deleteReference(lastShaBeforeCommit, References::Type::LocalBranch, mGit->getCurrentBranch());
-         mCache->insertReference(commit.sha, References::Type::LocalBranch, mGit->getCurrentBranch());
+         mCache->moveReference(lastShaBeforeCommit, commit.sha, References::Type::LocalBranch,
+                               mGit->getCurrentBranch());
 
          QScopedPointer<GitHistory> gitHistory(new GitHistory(mGit));
          const auto ret = gitHistory->getDiffFiles(commit.sha, lastShaBeforeCommit);
@@ -44,6 +44,7 @@ class GitServerCache;
 class QLabel;
 class GitQlientSettings;
 class QSplitter;
+class QTimer;
 struct GitExecResult;
 
 /*!
@@ -205,6 +206,20 @@ public:
    */
    void updateGraphView(int totalCommits);
 
+   /*!
+    \brief Appends the new rows to the graph view while the repository is still loading.
+
+    \param totalCommits The new total of commits to show in the graph.
+   */
+   void appendGraphRows(int totalCommits);
+   /*!
+    \brief Inserts the rows of the new commits added on top of the history without reloading the graph view.
+
+    \param newCommits The number of commits inserted after the WIP.
+    \param changedRows The number of rows on top of the history whose graph changed, the new ones included.
+   */
+   void insertGraphRows(int newCommits, int changedRows);
+
    /**
     * @brief onCommitTitleMaxLenghtChanged Changes the maximum length of the commit title.
     */
@@ -240,12 +255,15 @@ private:
    CommitHistoryView *mRepositoryView = nullptr;
    BranchesWidget *mBranchesWidget = nullptr;
    QLineEdit *mSearchInput = nullptr;
+   QTimer *mFilterTimer = nullptr;
+   QStringList mSearchResults;
    QStackedWidget *mCommitStackedWidget = nullptr;
    QStackedWidget *mCenterStackedWidget = nullptr;
    CommitChangesWidget *mWipWidget = nullptr;
    CommitChangesWidget *mAmendWidget = nullptr;
    CommitInfoWidget *mCommitInfoWidget = nullptr;
    CheckBox *mChShowAllBranches = nullptr;
+   CheckBox *mChFilterByPath = nullptr;
    RepositoryViewDelegate *mItemDelegate = nullptr;
    QFrame *mGraphFrame = nullptr;
    FileDiffWidget *mFileDiff = nullptr;
@@ -261,6 +279,12 @@ private:
 
    */
    void search();
+   /*!
+    \brief Filters the history with the commits that match the text of the search QLineEdit. The filter is removed when
+    the text is too short. When filtering by path, the history shows the commits that changed the file or folder.
+
+   */
+   void filterHistory();
    /*!
     \brief Goes to the selected SHA.
 
@@ -123,10 +123,8 @@ void BranchContextMenu::push()
          const auto oldSha = mConfig.mCache->getShaOfReference(
              QString("%1/%2").arg(remote.output, mConfig.branchSelected), References::Type::RemoteBranches);
          const auto sha = mConfig.mCache->getShaOfReference(mConfig.branchSelected, References::Type::LocalBranch);
-         mConfig.mCache->deleteReference(oldSha, References::Type::RemoteBranches,
-                                         QString("%1/%2").arg(remote.output, mConfig.branchSelected));
-         mConfig.mCache->insertReference(sha, References::Type::RemoteBranches,
-                                         QString("%1/%2").arg(remote.output, mConfig.branchSelected));
+         mConfig.mCache->moveReference(oldSha, sha, References::Type::RemoteBranches,
+                                       QString("%1/%2").arg(remote.output, mConfig.branchSelected));
          emit mConfig.mCache->signalCacheUpdated();
          emit logReload();
       }
@@ -74,7 +74,21 @@ void BranchesViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &o, con
 
    p->setFont(newOpt.font);
 
-   const auto elidedText = fm.elidedText(i.data().toString(), Qt::ElideRight, newOpt.rect.width());
+   // The local branches show how far they are from their upstream at the right side.
+   QString distances;
+
+   if (i.column() == 0 && i.data(AheadRole).isValid())
+   {
+      const auto ahead = i.data(AheadRole).toInt();
+      const auto behind = i.data(BehindRole).toInt();
+
+      if (ahead != 0 || behind != 0)
+         distances = QString("%1%2 %3%4").arg(ahead).arg(QChar(0x2191)).arg(behind).arg(QChar(0x2193));
+   }
+
+   const auto distancesWidth = distances.isEmpty() ? 0 : fm.horizontalAdvance(distances) + offset;
+   const auto elidedText
+       = fm.elidedText(i.data().toString(), Qt::ElideRight, newOpt.rect.width() - distancesWidth);
 
    if (i.column() == 0)
       newOpt.rect.setX(newOpt.rect.x() + iconSize + offset);
@@ -82,6 +96,13 @@ void BranchesViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &o, con
       newOpt.rect.setX(newOpt.rect.x() + iconSize - offset);
 
    p->drawText(newOpt.rect, elidedText, QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
+
+   if (!distances.isEmpty())
+   {
+      QRect distancesRect(newOpt.rect);
+      distancesRect.setRight(distancesRect.right() - offset);
+      p->drawText(distancesRect, distances, QTextOption(Qt::AlignRight | Qt::AlignVCenter));
+   }
 }
 
 QSize BranchesViewDelegate::sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const
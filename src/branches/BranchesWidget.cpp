@@ -27,6 +27,7 @@
 #include <QPushButton>
 #include <QScopedPointer>
 #include <QToolButton>
+#include <QTreeWidgetItemIterator>
 #include <QVBoxLayout>
 
 #include <QLogger.h>
@@ -51,6 +52,28 @@ QTreeWidgetItem *getChild(QTreeWidgetItem *parent, const QString &childName)
 
    return child;
 }
+
+void setBranchDistances(QTreeWidgetItem *item, const std::optional<GitCache::LocalBranchDistances> &distances)
+{
+   const auto fullBranchName = item->data(0, FullNameRole).toString();
+
+   if (distances)
+   {
+      item->setData(0, AheadRole, distances->aheadOrigin);
+      item->setData(0, BehindRole, distances->behindOrigin);
+      item->setData(0, Qt::ToolTipRole,
+                    QObject::tr("%1\n%2 commits ahead, %3 commits behind its upstream")
+                        .arg(fullBranchName)
+                        .arg(distances->aheadOrigin)
+                        .arg(distances->behindOrigin));
+   }
+   else
+   {
+      item->setData(0, AheadRole, QVariant());
+      item->setData(0, BehindRole, QVariant());
+      item->setData(0, Qt::ToolTipRole, fullBranchName);
+   }
+}
 }
 
 BranchesWidget::BranchesWidget(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git,
@@ -76,6 +99,8 @@ BranchesWidget::BranchesWidget(const QSharedPointer<GitCache> &cache, const QSha
 {
    connect(mCache.get(), &GitCache::signalCacheUpdated, this, &BranchesWidget::showBranches);
    connect(mCache.get(), &GitCache::signalCacheUpdated, this, &BranchesWidget::processTags);
+   connect(mCache.get(), &GitCache::signalLocalBranchDistancesUpdated, this,
+           &BranchesWidget::updateLocalBranchDistances);
 
    setAttribute(Qt::WA_DeleteOnClose);
 
@@ -580,8 +605,8 @@ void BranchesWidget::processLocalBranch(const QString &sha, QString branch)
    item->setData(0, GitQlient::FullNameRole, fullBranchName);
    item->setData(0, GitQlient::LocalBranchRole, true);
    item->setData(0, GitQlient::ShaRole, sha);
-   item->setData(0, Qt::ToolTipRole, fullBranchName);
    item->setData(0, GitQlient::IsLeaf, true);
+   setBranchDistances(item, mCache->getLocalBranchDistances(fullBranchName));
 
    if (isCurrentBranch)
    {
@@ -614,6 +639,15 @@ void BranchesWidget::processLocalBranch(const QString &sha, QString branch)
    QLog_Debug("UI", QString("Finish gathering local branch information"));
 }
 
+void BranchesWidget::updateLocalBranchDistances()
+{
+   for (QTreeWidgetItemIterator iter(mLocalBranchesTree); *iter; ++iter)
+   {
+      if ((*iter)->data(0, IsLeaf).toBool())
+         setBranchDistances(*iter, mCache->getLocalBranchDistances((*iter)->data(0, FullNameRole).toString()));
+   }
+}
+
 void BranchesWidget::processRemoteBranch(const QString &sha, QString branch)
 {
    const auto fullBranchName = branch;
@@ -830,15 +864,23 @@ void BranchesWidget::processSubtrees()
 {
    mSubtreeList->clear();
 
-   QScopedPointer<GitSubtree> git(new GitSubtree(mGit));
+   // The cache indexes the subtrees as the commits are loaded. Git is only asked while the history is not loaded or
+   // when only its newest commits are.
+   auto subtrees = mCache->getSubtrees();
 
-   const auto ret = git->list();
-
-   if (ret.success)
+   if (!subtrees)
    {
+      QScopedPointer<GitSubtree> git(new GitSubtree(mGit));
+
+      const auto ret = git->list();
+
+      if (!ret.success)
+         return;
+
+      subtrees = QMap<QString, QString>();
+
       const auto rawData = ret.output;
       const auto commits = rawData.split("\n\n");
-      auto count = 0;
 
       for (auto &subtreeRawData : commits)
       {
@@ -856,13 +898,16 @@ void BranchesWidget::processSubtrees()
                   sha = field.remove("git-subtree-split:").trimmed();
             }
 
-            mSubtreeList->addItem(name);
-            ++count;
+            if (!name.isEmpty() && !subtrees->contains(name))
+               subtrees->insert(name, sha);
          }
       }
-
-      mSubtreeCount->setText('(' + QString::number(count) + ')');
    }
+
+   for (auto iter = subtrees->cbegin(); iter != subtrees->cend(); ++iter)
+      mSubtreeList->addItem(iter.key());
+
+   mSubtreeCount->setText('(' + QString::number(subtrees->count()) + ')');
 }
 
 void BranchesWidget::adjustBranchesTree(BranchTreeWidget *treeWidget)
@@ -200,6 +200,10 @@ private:
     \param branch The remote branch to be added in the tree widget.
    */
    void processRemoteBranch(const QString &sha, QString branch);
+   /*!
+    \brief Shows in the local branches how many commits they are ahead and behind their upstream.
+   */
+   void updateLocalBranchDistances();
    /*!
     \brief Process all the tags and adds them into the QListWidget.
 
@@ -34,6 +34,8 @@ enum GitQlientBranchItemRole
    LocalBranchRole,
    ShaRole,
    IsLeaf,
-   IsRoot
+   IsRoot,
+   AheadRole,
+   BehindRole
 };
 }
@@ -1,21 +1,33 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/ChangedPathsIndex.h \
     $$PWD/CommitInfo.h \
+    $$PWD/CommitPages.h \
+    $$PWD/CommitSearchIndex.h \
     $$PWD/GitCache.h \
     $$PWD/GitServerCache.h \
+    $$PWD/HistorySnapshot.h \
+    $$PWD/ObjectId.h \
     $$PWD/Lane.h \
     $$PWD/LaneType.h \
     $$PWD/References.h \
     $$PWD/RevisionFiles.h \
+    $$PWD/ShaIndex.h \
     $$PWD/WipRevisionInfo.h \
     $$PWD/lanes.h
 
 SOURCES += \
+    $$PWD/ChangedPathsIndex.cpp \
     $$PWD/CommitInfo.cpp \
+    $$PWD/CommitPages.cpp \
+    $$PWD/CommitSearchIndex.cpp \
     $$PWD/GitCache.cpp \
     $$PWD/GitServerCache.cpp \
+    $$PWD/HistorySnapshot.cpp \
+    $$PWD/ObjectId.cpp \
     $$PWD/Lane.cpp \
     $$PWD/References.cpp \
     $$PWD/RevisionFiles.cpp \
+    $$PWD/ShaIndex.cpp \
     $$PWD/lanes.cpp
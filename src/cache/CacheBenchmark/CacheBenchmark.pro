@@ -0,0 +1,32 @@
+QT -= gui
+QT += testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = CacheBenchmark
+
+# The benchmark builds the classes of the cache that don't depend on the rest of GitQlient.
+INCLUDEPATH += $$PWD/..
+
+HEADERS += \
+    $$PWD/../CommitInfo.h \
+    $$PWD/../CommitPages.h \
+    $$PWD/../Lane.h \
+    $$PWD/../LaneType.h \
+    $$PWD/../ObjectId.h \
+    $$PWD/../References.h \
+    $$PWD/../ShaIndex.h \
+    $$PWD/../lanes.h \
+    ReferenceLanes.h
+
+SOURCES += \
+    $$PWD/../CommitInfo.cpp \
+    $$PWD/../CommitPages.cpp \
+    $$PWD/../Lane.cpp \
+    $$PWD/../ObjectId.cpp \
+    $$PWD/../References.cpp \
+    $$PWD/../ShaIndex.cpp \
+    $$PWD/../lanes.cpp \
+    ReferenceLanes.cpp \
+    main.cpp
@@ -0,0 +1,457 @@
+#include "ReferenceLanes.h"
+
+#include <CommitInfo.h>
+#include <CommitPages.h>
+#include <ShaIndex.h>
+#include <lanes.h>
+
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtTest>
+
+#include <atomic>
+#include <cstring>
+#include <string_view>
+
+#if defined(__GLIBC__)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+
+namespace
+{
+std::atomic<quint64> allocations { 0 };
+}
+
+// Qt allocates its containers with malloc, so the allocations are counted there instead of in operator new.
+extern "C" void *malloc(size_t size)
+{
+   ++allocations;
+   return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+   ++allocations;
+   return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+   ++allocations;
+   return __libc_realloc(pointer, size);
+}
+#endif
+
+namespace
+{
+// The size of the synthetic history. It can be changed with the variable CACHE_BENCHMARK_COMMITS.
+const auto DEFAULT_COMMITS = 1000000;
+
+// One commit out of MERGE_INTERVAL is a merge of the next two.
+const auto MERGE_INTERVAL = 50;
+
+// The same values as GitCache.
+const auto LANES_CHECKPOINT_INTERVAL = 256;
+const auto LANES_CACHE_ROWS = 4096;
+
+qint64 allocationsCount()
+{
+#if defined(__GLIBC__)
+   return static_cast<qint64>(allocations.load());
+#else
+   return -1;
+#endif
+}
+
+void report(const char *what, int count, qint64 nanoseconds, qint64 allocationsDone)
+{
+   const auto perSecond = nanoseconds > 0 ? count * 1e9 / nanoseconds : 0.0;
+
+   if (allocationsDone < 0)
+      qInfo("%s: %d commits in %lld ms, %.0f commits/s", what, count, nanoseconds / 1000000, perSecond);
+   else
+   {
+      qInfo("%s: %d commits in %lld ms, %.0f commits/s, %.2f allocations per commit", what, count,
+            nanoseconds / 1000000, perSecond, count > 0 ? static_cast<double>(allocationsDone) / count : 0.0);
+   }
+}
+
+/**
+ * @brief Walks the '\0' separated records of a raw log the same way GitRepoLoader does.
+ */
+template<typename Callback>
+void forEachLogRecord(const QByteArray &log, Callback callback)
+{
+   auto begin = log.constData();
+   const auto end = begin + log.size();
+
+   while (begin < end)
+   {
+      auto recordEnd = static_cast<const char *>(memchr(begin, '\000', static_cast<size_t>(end - begin)));
+
+      if (!recordEnd)
+         recordEnd = end;
+
+      callback(std::string_view(begin, static_cast<size_t>(recordEnd - begin)));
+
+      begin = recordEnd + 1;
+   }
+}
+
+/**
+ * @brief Calculates the lanes of a commit and moves them to its first parent, the same way GitCache does. It works
+ * both with the current Lanes and with ReferenceLanes.
+ */
+template<typename LanesType, typename Id, typename Parents>
+QVector<Lane> nextLanes(LanesType &lanes, const Id &sha, const Parents &parents, const Id &noSha)
+{
+   bool isDiscontinuity;
+   const auto isFork = lanes.isFork(sha, isDiscontinuity);
+   const auto parentsCount = parents.count();
+
+   if (isDiscontinuity)
+      lanes.changeActiveLane(sha);
+
+   if (isFork)
+      lanes.setFork(sha);
+   if (parentsCount > 1)
+      lanes.setMerge(parents);
+   if (parentsCount == 0)
+      lanes.setInitial();
+
+   const auto row = lanes.getLanes();
+
+   lanes.nextParent(parentsCount == 0 ? noSha : parents.constFirst());
+
+   if (parentsCount > 1)
+      lanes.afterMerge();
+   if (isFork)
+      lanes.afterFork();
+   if (lanes.isBranch())
+      lanes.afterBranch();
+
+   return row;
+}
+
+/**
+ * @brief Reads the history to replay from CACHE_BENCHMARK_PARENTS when it's set, or takes the synthetic one. The file
+ * must have the format of the output of git rev-list --topo-order --parents --all, with the SHA of a commit followed
+ * by its parents in every line.
+ */
+bool readHistory(const QStringList &syntheticShas, const QVector<QStringList> &syntheticParents, QStringList &shas,
+                 QVector<QStringList> &parents)
+{
+   const auto fileName = qEnvironmentVariable("CACHE_BENCHMARK_PARENTS");
+
+   if (fileName.isEmpty())
+   {
+      shas = syntheticShas;
+      parents = syntheticParents;
+      return !shas.isEmpty();
+   }
+
+   QFile file(fileName);
+
+   if (!file.open(QIODevice::ReadOnly))
+   {
+      qWarning("Cannot read %s", qPrintable(fileName));
+      return false;
+   }
+
+   while (!file.atEnd())
+   {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+      auto line = QString::fromLatin1(file.readLine().trimmed()).split(' ', Qt::SkipEmptyParts);
+#else
+      auto line = QString::fromLatin1(file.readLine().trimmed()).split(' ', QString::SkipEmptyParts);
+#endif
+
+      if (!line.isEmpty())
+      {
+         shas.append(line.takeFirst());
+         parents.append(line);
+      }
+   }
+
+   return !shas.isEmpty();
+}
+}
+
+class CacheBenchmark : public QObject
+{
+   Q_OBJECT
+
+private slots:
+   void initTestCase();
+   void parseLog();
+   void storeCommits();
+   void buildShaIndex();
+   void findAbbreviatedSha();
+   void replayLanes();
+   void lanesMemory();
+
+private:
+   int mCommitsCount = DEFAULT_COMMITS;
+   QStringList mShas;
+   QVector<QStringList> mParents;
+   QByteArray mLog;
+   ShaIndex mShaIndex;
+};
+
+void CacheBenchmark::initTestCase()
+{
+   if (const auto count = qEnvironmentVariableIntValue("CACHE_BENCHMARK_COMMITS"); count > 0)
+      mCommitsCount = count;
+
+   mShas.reserve(mCommitsCount);
+
+   for (auto i = 0; i < mCommitsCount; ++i)
+   {
+      const auto hash = QCryptographicHash::hash(QByteArray::number(i), QCryptographicHash::Sha1);
+      mShas.append(QString::fromLatin1(hash.toHex()));
+   }
+
+   // The records have the format of GIT_LOG_FORMAT with --log-size and -z, from the newest commit to the oldest.
+   mParents.resize(mCommitsCount);
+   mLog.reserve(mCommitsCount * 260);
+
+   for (auto i = 0; i < mCommitsCount; ++i)
+   {
+      auto &parents = mParents[i];
+
+      if (i + 1 < mCommitsCount)
+         parents.append(mShas.at(i + 1));
+
+      if (i % MERGE_INTERVAL == 0 && i + 2 < mCommitsCount)
+         parents.append(mShas.at(i + 2));
+
+      QByteArray record = ">" + mShas.at(i).toLatin1() + "X" + parents.join(' ').toLatin1();
+
+      record += "\nCommitter Name<committer@example.com>\nAuthor Name<author@example.com>\n";
+      record += QByteArray::number(1600000000 + mCommitsCount - i);
+      record += "\nChange number " + QByteArray::number(i) + " of the synthetic history\n";
+      record += "The body of the commit explains the change\nin a couple of lines. ";
+
+      mLog += "log size " + QByteArray::number(record.size()) + "\n" + record + '\0';
+   }
+
+   mShaIndex.reserve(mCommitsCount);
+
+   for (const auto &sha : qAsConst(mShas))
+      mShaIndex.insert(sha);
+
+   mShaIndex.sort();
+
+   qInfo("Synthetic history: %d commits, %d MiB of log", mCommitsCount, mLog.size() / (1024 * 1024));
+}
+
+void CacheBenchmark::parseLog()
+{
+   auto parsed = 0;
+
+   QBENCHMARK_ONCE
+   {
+      const auto allocationsBefore = allocationsCount();
+      QElapsedTimer timer;
+      timer.start();
+
+      forEachLogRecord(mLog, [&parsed](std::string_view record) {
+         if (const CommitInfo commit { record }; commit.isValid())
+            ++parsed;
+      });
+
+      const auto elapsed = timer.nsecsElapsed();
+      const auto allocationsDone = allocationsBefore < 0 ? -1 : allocationsCount() - allocationsBefore;
+
+      report("Parse", parsed, elapsed, allocationsDone);
+   }
+
+   QCOMPARE(parsed, mCommitsCount);
+}
+
+void CacheBenchmark::storeCommits()
+{
+   CommitPages pages;
+
+   QBENCHMARK_ONCE
+   {
+      const auto allocationsBefore = allocationsCount();
+      QElapsedTimer timer;
+      timer.start();
+
+      pages.reserve(mCommitsCount);
+
+      forEachLogRecord(mLog, [&pages](std::string_view record) {
+         if (const CommitInfo commit { record }; commit.isValid())
+            pages.append(commit);
+      });
+
+      const auto elapsed = timer.nsecsElapsed();
+      const auto allocationsDone = allocationsBefore < 0 ? -1 : allocationsCount() - allocationsBefore;
+
+      report("Parse and store", pages.count(), elapsed, allocationsDone);
+   }
+
+   QCOMPARE(pages.count(), mCommitsCount);
+   QCOMPARE(pages.sha(mCommitsCount - 1), mShas.constLast());
+}
+
+void CacheBenchmark::buildShaIndex()
+{
+   QBENCHMARK_ONCE
+   {
+      QElapsedTimer timer;
+      timer.start();
+
+      ShaIndex index;
+      index.reserve(mCommitsCount);
+
+      for (const auto &sha : qAsConst(mShas))
+         index.insert(sha);
+
+      index.sort();
+
+      report("SHA index", mCommitsCount, timer.nsecsElapsed(), -1);
+
+      QCOMPARE(index.find(mShas.constFirst()).type, ShaIndex::MatchType::Unique);
+   }
+}
+
+void CacheBenchmark::findAbbreviatedSha()
+{
+   // Every lookup is a different commit, spread along the whole history.
+   const auto step = qMax(1, mCommitsCount / 1000);
+   auto found = 0;
+
+   QBENCHMARK
+   {
+      found = 0;
+
+      for (auto i = 0; i < mCommitsCount; i += step)
+      {
+         if (mShaIndex.find(mShas.at(i).left(12)).type == ShaIndex::MatchType::Unique)
+            ++found;
+      }
+   }
+
+   QCOMPARE(found, (mCommitsCount + step - 1) / step);
+}
+
+void CacheBenchmark::replayLanes()
+{
+   QStringList shas;
+   QVector<QStringList> parents;
+   QVERIFY(readHistory(mShas, mParents, shas, parents));
+
+   const auto count = shas.count();
+
+   // GitCache takes the ids of the commits from the stored ones, so they are not part of the time measured.
+   QVector<quint64> ids;
+   QVector<QVector<quint64>> parentIds;
+   ids.reserve(count);
+   parentIds.reserve(count);
+
+   for (auto i = 0; i < count; ++i)
+   {
+      ids.append(Lanes::shaId(shas.at(i)));
+
+      QVector<quint64> commitParentIds;
+
+      for (const auto &parent : parents.at(i))
+         commitParentIds.append(Lanes::shaId(parent));
+
+      parentIds.append(commitParentIds);
+   }
+
+   QVector<QVector<Lane>> referenceRows(count);
+   QElapsedTimer timer;
+   timer.start();
+
+   ReferenceLanes referenceLanes;
+   referenceLanes.init(shas.constFirst());
+
+   for (auto i = 0; i < count; ++i)
+      referenceRows[i] = nextLanes(referenceLanes, shas.at(i), parents.at(i), QString());
+
+   report("Lanes with SHA strings", count, timer.nsecsElapsed(), -1);
+
+   QVector<QVector<Lane>> rows(count);
+
+   QBENCHMARK_ONCE
+   {
+      timer.start();
+
+      Lanes lanes;
+      lanes.init(ids.constFirst());
+
+      for (auto i = 0; i < count; ++i)
+         rows[i] = nextLanes(lanes, ids.at(i), parentIds.at(i), Lanes::NO_SHA);
+
+      report("Lanes with ids", count, timer.nsecsElapsed(), -1);
+   }
+
+   auto widest = 0;
+
+   for (auto i = 0; i < count; ++i)
+   {
+      QVERIFY2(rows.at(i) == referenceRows.at(i), qPrintable(QString("Different lanes for %1").arg(shas.at(i))));
+      widest = qMax(widest, rows.at(i).count());
+   }
+
+   qInfo("Lanes replayed: %d commits, %d lanes in the widest row", count, widest);
+}
+
+void CacheBenchmark::lanesMemory()
+{
+   QStringList shas;
+   QVector<QStringList> parents;
+   QVERIFY(readHistory(mShas, mParents, shas, parents));
+
+   // The sizes are estimated from the containers: a QVector is a pointer to a header followed by its elements.
+   const auto vectorSize = static_cast<qint64>(sizeof(QVector<Lane>) + sizeof(QArrayData));
+   const auto count = shas.count();
+   qint64 lanesCount = 0;
+   qint64 checkpointsBytes = 0;
+   qint64 widestRowBytes = 0;
+
+   Lanes lanes;
+   lanes.init(Lanes::shaId(shas.constFirst()));
+
+   for (auto i = 0; i < count; ++i)
+   {
+      QVector<quint64> parentIds;
+
+      for (const auto &parent : parents.at(i))
+         parentIds.append(Lanes::shaId(parent));
+
+      // A checkpoint keeps the lane types, the next id of each lane and the hash of the ids.
+      if (i % LANES_CHECKPOINT_INTERVAL == 0)
+      {
+         const auto lanesCount = static_cast<qint64>(lanes.getLanes().count());
+         checkpointsBytes += static_cast<qint64>(sizeof(Lanes)) + 2 * vectorSize
+             + lanesCount * static_cast<qint64>(sizeof(Lane) + sizeof(quint64))
+             + lanesCount * static_cast<qint64>(sizeof(quint64) + sizeof(void *) + vectorSize + sizeof(int));
+      }
+
+      const auto row = nextLanes(lanes, Lanes::shaId(shas.at(i)), parentIds, Lanes::NO_SHA);
+
+      lanesCount += row.count();
+      widestRowBytes = qMax(widestRowBytes, vectorSize + row.count() * static_cast<qint64>(sizeof(Lane)));
+   }
+
+   // Every commit used to keep its own row, and the lane types took four bytes before they were stored in one. Now
+   // only the checkpoints and the rows painted last are kept.
+   const auto oldBytes = count * vectorSize + lanesCount * static_cast<qint64>(sizeof(int));
+   const auto newBytes = checkpointsBytes + qMin(count, LANES_CACHE_ROWS) * widestRowBytes;
+
+   qInfo("Graph memory for %d commits: %lld KiB with a row per commit, %lld KiB with checkpoints (%.1fx less)", count,
+         oldBytes / 1024, newBytes / 1024, newBytes > 0 ? static_cast<double>(oldBytes) / newBytes : 0.0);
+
+   QVERIFY(newBytes < oldBytes || count <= LANES_CACHE_ROWS);
+}
+
+QTEST_APPLESS_MAIN(CacheBenchmark)
+
+#include "main.moc"
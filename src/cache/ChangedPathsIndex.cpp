@@ -0,0 +1,167 @@
+#include "ChangedPathsIndex.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+const quint32 ChangedPathsIndex::MAGIC = 0x47514350; // GQCP
+const quint32 ChangedPathsIndex::VERSION = 1;
+
+void ChangedPathsIndex::clear()
+{
+   mShas.clear();
+   mShas.squeeze();
+   mPaths.clear();
+   mRenames.clear();
+   mRenames.squeeze();
+}
+
+void ChangedPathsIndex::insert(const QString &sha, const QString &path)
+{
+   const auto commit = document(sha);
+   auto &postings = mPaths[path];
+
+   if (postings.isEmpty() || postings.constLast() != commit)
+      postings.append(commit);
+}
+
+void ChangedPathsIndex::insertRename(const QString &sha, const QString &oldPath, const QString &newPath)
+{
+   insert(sha, oldPath);
+   insert(sha, newPath);
+
+   mRenames[newPath].append(qMakePair(document(sha), oldPath));
+}
+
+void ChangedPathsIndex::merge(const ChangedPathsIndex &other)
+{
+   const auto offset = mShas.count();
+
+   mShas += other.mShas;
+
+   for (auto iter = other.mPaths.cbegin(); iter != other.mPaths.cend(); ++iter)
+   {
+      auto &postings = mPaths[iter.key()];
+
+      for (const auto commit : iter.value())
+         postings.append(commit + offset);
+   }
+
+   for (auto iter = other.mRenames.cbegin(); iter != other.mRenames.cend(); ++iter)
+   {
+      auto &renames = mRenames[iter.key()];
+
+      for (const auto &rename : iter.value())
+         renames.append(qMakePair(rename.first + offset, rename.second));
+   }
+}
+
+QStringList ChangedPathsIndex::commits(const QString &path) const
+{
+   QSet<int> found;
+
+   if (const auto iter = mPaths.constFind(path); iter != mPaths.cend())
+   {
+      for (const auto commit : iter.value())
+         found.insert(commit);
+   }
+
+   // The paths are sorted, so the files under a directory are all together after it.
+   const auto prefix = path + QLatin1Char('/');
+
+   for (auto iter = mPaths.lowerBound(prefix); iter != mPaths.cend() && iter.key().startsWith(prefix); ++iter)
+   {
+      for (const auto commit : iter.value())
+         found.insert(commit);
+   }
+
+   QStringList shas;
+   shas.reserve(found.count());
+
+   for (const auto commit : qAsConst(found))
+      shas.append(mShas.at(commit));
+
+   return shas;
+}
+
+QVector<QPair<QString, QString>> ChangedPathsIndex::renames(const QString &path) const
+{
+   QVector<QPair<QString, QString>> renames;
+
+   for (const auto &rename : mRenames.value(path))
+      renames.append(qMakePair(mShas.at(rename.first), rename.second));
+
+   return renames;
+}
+
+bool ChangedPathsIndex::load(const QString &filePath, QMap<QString, QString> &tips)
+{
+   clear();
+   tips.clear();
+
+   QFile file(filePath);
+
+   if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+      return false;
+
+   QDataStream in(&file);
+   in.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic = 0;
+   quint32 version = 0;
+
+   in >> magic >> version;
+
+   if (magic != MAGIC || version != VERSION)
+   {
+      QLog_Info("Cache", QString("The index of the changed paths {%1} has an old format.").arg(filePath));
+      return false;
+   }
+
+   in >> tips >> mShas >> mPaths >> mRenames;
+
+   if (in.status() != QDataStream::Ok)
+   {
+      QLog_Warning("Cache", QString("The index of the changed paths {%1} is corrupted.").arg(filePath));
+
+      clear();
+      tips.clear();
+
+      return false;
+   }
+
+   QLog_Info("Cache", QString("Index of the changed paths loaded with {%1} commits.").arg(mShas.count()));
+
+   return true;
+}
+
+bool ChangedPathsIndex::save(const QString &filePath, const QMap<QString, QString> &tips) const
+{
+   QSaveFile file(filePath);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Cache", QString("The index of the changed paths {%1} couldn't be written.").arg(filePath));
+      return false;
+   }
+
+   QDataStream out(&file);
+   out.setVersion(QDataStream::Qt_5_9);
+   out << MAGIC << VERSION << tips << mShas << mPaths << mRenames;
+
+   return file.commit();
+}
+
+int ChangedPathsIndex::document(const QString &sha)
+{
+   // The paths of a commit are added together: only the last commit can be the same one.
+   if (mShas.isEmpty() || mShas.constLast() != sha)
+      mShas.append(sha);
+
+   return mShas.count() - 1;
+}
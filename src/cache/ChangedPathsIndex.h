@@ -0,0 +1,113 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief The ChangedPathsIndex class stores, for every path of the repository, the commits that changed it. It answers
+ * the history of a file or a directory without asking Git to walk the whole history again.
+ *
+ * The renames are stored from the new path to the commit and the path before the rename, so the history of a file can
+ * be followed through them.
+ *
+ * The index can be stored in disk with the tips of the references it was built from, so it only needs to be updated
+ * with the new commits when the repository is opened again.
+ *
+ * The class is not thread safe: it's protected by the cache that owns it.
+ *
+ * @class ChangedPathsIndex ChangedPathsIndex.h "ChangedPathsIndex.h"
+ */
+class ChangedPathsIndex
+{
+public:
+   /**
+    * @brief Removes all the commits from the index.
+    */
+   void clear();
+
+   /**
+    * @brief Returns true if no commit has been added to the index.
+    */
+   bool isEmpty() const { return mShas.isEmpty(); }
+
+   /**
+    * @brief Adds a path changed by the commit @p sha. The paths of a commit are expected to be added together.
+    */
+   void insert(const QString &sha, const QString &path);
+
+   /**
+    * @brief Adds a file renamed by the commit @p sha. The commit is added to both paths.
+    */
+   void insertRename(const QString &sha, const QString &oldPath, const QString &newPath);
+
+   /**
+    * @brief Adds all the commits and paths of @p other to the index.
+    */
+   void merge(const ChangedPathsIndex &other);
+
+   /**
+    * @brief Returns the commits that changed the file @p path or any file under it if it's a directory.
+    * @param path The path relative to the root of the repository.
+    * @return The SHAs of the commits, in no particular order.
+    */
+   QStringList commits(const QString &path) const;
+
+   /**
+    * @brief Returns the renames that created the file @p path.
+    * @return The SHA of the commit and the path before the rename for every rename found.
+    */
+   QVector<QPair<QString, QString>> renames(const QString &path) const;
+
+   /**
+    * @brief Loads the index from disk, replacing its content.
+    * @param filePath The absolute path to the file.
+    * @param tips The references and the SHA they pointed to when the index was saved.
+    * @return True if the file exists and has the current version, otherwise false and the index is left empty.
+    */
+   bool load(const QString &filePath, QMap<QString, QString> &tips);
+
+   /**
+    * @brief Writes the index to disk.
+    * @param filePath The absolute path to the file.
+    * @param tips The references and the SHA they pointed to when the index was built.
+    * @return True if the file was written, otherwise false.
+    */
+   bool save(const QString &filePath, const QMap<QString, QString> &tips) const;
+
+private:
+   static const quint32 MAGIC;
+   static const quint32 VERSION;
+
+   QVector<QString> mShas;
+   QMap<QString, QVector<int>> mPaths;
+   QHash<QString, QVector<QPair<int, QString>>> mRenames;
+
+   int document(const QString &sha);
+};
@@ -2,48 +2,97 @@
 
 #include <QStringList>
 
+#include <algorithm>
+#include <cstring>
+
 const QString CommitInfo::ZERO_SHA = QString("0000000000000000000000000000000000000000");
 const QString CommitInfo::INIT_SHA = QString("4b825dc642cb6eb9a060e54bf8d69288fbee4904");
 
+namespace
+{
+/**
+ * @brief Extracts the first line of @p data and moves @p data after its end. memchr is used because it's vectorized by
+ * the C library, so the lines are found without checking every byte one by one.
+ */
+std::string_view takeLine(std::string_view &data)
+{
+   const auto end = static_cast<const char *>(memchr(data.data(), '\n', data.size()));
+   const auto length = end ? static_cast<size_t>(end - data.data()) : data.size();
+   const auto line = data.substr(0, length);
+
+   data.remove_prefix(end ? length + 1 : length);
+
+   return line;
+}
+
+QString toString(std::string_view text)
+{
+   return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+}
+
 CommitInfo::CommitInfo(QByteArray commitData, const QString &gpg, bool goodSignature)
    : gpgKey(gpg)
    , mGoodSignature(goodSignature)
 {
-   parseDiff(commitData, 0);
+   parseDiff(std::string_view(commitData.constData(), static_cast<size_t>(commitData.size())), 0);
 }
 
 CommitInfo::CommitInfo(QByteArray data)
 {
-    parseDiff(data, 1);
+   parseDiff(std::string_view(data.constData(), static_cast<size_t>(data.size())), 1);
 }
 
-void CommitInfo::parseDiff(QByteArray &data, int startingField)
+CommitInfo::CommitInfo(std::string_view record)
 {
-    if (const auto fields = QString::fromUtf8(data).split('\n'); fields.count() > 0)
-    {
-       const auto firstField = fields.constFirst();
-       auto combinedShas = fields.at(startingField++);
-       auto shas = combinedShas.split('X');
-       sha = shas.takeFirst().remove(0, 1);
+   parseDiff(record, 1);
+}
+
+void CommitInfo::parseDiff(std::string_view data, int startingField)
+{
+   for (auto i = 0; i < startingField && !data.empty(); ++i)
+      takeLine(data);
+
+   // The first line has the format <boundary mark><SHA>X<parents separated by spaces>
+   auto shas = takeLine(data);
+
+   if (shas.size() < 41)
+      return;
 
-       if (!shas.isEmpty())
-       {
- #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-          mParentsSha = shas.takeFirst().split(' ', Qt::SkipEmptyParts);
- #else
-          mParentsSha = shas.takeFirst().split(' ', QString::SkipEmptyParts);
- #endif
-       }
-       committer = fields.at(startingField++);
-       author = fields.at(startingField++);
-       dateSinceEpoch = std::chrono::seconds(fields.at(startingField++).toInt());
-       shortLog = fields.at(startingField);
+   sha = QString::fromLatin1(shas.data() + 1, 40);
+   shas.remove_prefix(41);
 
-       for (auto i = 6; i < fields.count(); ++i)
-          longLog += fields.at(i) + '\n';
+   if (!shas.empty() && shas.front() == 'X')
+   {
+      shas.remove_prefix(1);
+
+      while (!shas.empty())
+      {
+         const auto parent = shas.substr(0, shas.find(' '));
 
-       longLog = longLog.trimmed();
-    }
+         if (!parent.empty())
+            mParentsSha.append(QString::fromLatin1(parent.data(), static_cast<int>(parent.size())));
+
+         shas.remove_prefix(std::min(parent.size() + 1, shas.size()));
+      }
+   }
+
+   committer = toString(takeLine(data));
+   author = toString(takeLine(data));
+
+   auto seconds = 0LL;
+
+   for (const auto digit : takeLine(data))
+   {
+      if (digit < '0' || digit > '9')
+         break;
+
+      seconds = seconds * 10 + (digit - '0');
+   }
+
+   dateSinceEpoch = std::chrono::seconds(seconds);
+   shortLog = toString(takeLine(data));
+   longLog = toString(data).trimmed();
 }
 
 CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, std::chrono::seconds commitDate,
@@ -67,7 +116,7 @@ bool CommitInfo::operator!=(const CommitInfo &commit) const
    return !(*this == commit);
 }
 
-bool CommitInfo::contains(const QString &value)
+bool CommitInfo::contains(const QString &value) const
 {
    return sha.startsWith(value, Qt::CaseInsensitive) || shortLog.contains(value, Qt::CaseInsensitive)
        || committer.contains(value, Qt::CaseInsensitive) || author.contains(value, Qt::CaseInsensitive);
@@ -95,16 +144,7 @@ QStringList CommitInfo::parents() const
 
 bool CommitInfo::isInWorkingBranch() const
 {
-   for (const auto &child : mChilds)
-   {
-      if (child->sha == CommitInfo::ZERO_SHA)
-      {
-         return true;
-         break;
-      }
-   }
-
-   return false;
+   return mInWorkingBranch;
 }
 
 void CommitInfo::setLanes(QVector<Lane> lanes)
@@ -116,9 +156,13 @@ void CommitInfo::setLanes(QVector<Lane> lanes)
 
 bool CommitInfo::isValid() const
 {
-   static QRegExp hexMatcher("^[0-9A-F]{40}$", Qt::CaseInsensitive);
+   if (sha.size() != 40)
+      return false;
 
-   return !sha.isEmpty() && hexMatcher.exactMatch(sha);
+   return std::all_of(sha.cbegin(), sha.cend(), [](const QChar &c) {
+      const auto ch = c.unicode();
+      return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+   });
 }
 
 int CommitInfo::getActiveLane() const
@@ -136,15 +180,3 @@ int CommitInfo::getActiveLane() const
    return -1;
 }
 
-void CommitInfo::removeChild(CommitInfo *commit)
-{
-   if (mChilds.contains(commit))
-      mChilds.removeAll(commit);
-}
-
-QString CommitInfo::getFirstChildSha() const
-{
-   if (!mChilds.isEmpty())
-      mChilds.constFirst();
-   return QString();
-}
@@ -28,6 +28,7 @@
 #include <QVector>
 
 #include <chrono>
+#include <string_view>
 
 #include <Lane.h>
 #include <References.h>
@@ -50,13 +51,19 @@ public:
    ~CommitInfo() = default;
    CommitInfo(QByteArray commitData);
    CommitInfo(QByteArray commitData, const QString &gpg, bool goodSignature);
+   /**
+    * @brief Builds the commit from a raw record of the log without copying it. Only the fields stored in the commit
+    * are decoded.
+    * @param record The record as it comes from Git. It must stay alive only during the construction.
+    */
+   explicit CommitInfo(std::string_view record);
    explicit CommitInfo(const QString &sha, const QStringList &parents, std::chrono::seconds commitDate,
                        const QString &log);
    bool operator==(const CommitInfo &commit) const;
    bool operator!=(const CommitInfo &commit) const;
 
    bool isValid() const;
-   bool contains(const QString &value);
+   bool contains(const QString &value) const;
 
    int parentsCount() const;
    QString firstParent() const;
@@ -69,11 +76,9 @@ public:
    Lane laneAt(int i) const { return mLanes.at(i); }
    int getActiveLane() const;
 
-   void appendChild(CommitInfo *commit) { mChilds.append(commit); }
-   void removeChild(CommitInfo *commit);
-   bool hasChilds() const { return !mChilds.empty(); }
-   QString getFirstChildSha() const;
-   int getChildsCount() const { return mChilds.count(); }
+   bool hasChilds() const { return mChildsCount > 0; }
+   int getFirstChildRow() const { return mFirstChildRow; }
+   int getChildsCount() const { return mChildsCount; }
 
    bool isSigned() const { return !gpgKey.isEmpty(); }
    bool verifiedSignature() const { return mGoodSignature && !gpgKey.isEmpty(); }
@@ -94,9 +99,16 @@ private:
    bool mGoodSignature = false;
    QVector<Lane> mLanes;
    QStringList mParentsSha;
-   QVector<CommitInfo *> mChilds;
+   // The children are only known by the cache: they are set when the commit is read from it.
+   int mChildsCount = 0;
+   int mFirstChildRow = -1;
+   bool mInWorkingBranch = false;
 
+   friend class CommitPages;
    friend class GitCache;
+   friend class HistorySnapshot;
 
-   void parseDiff(QByteArray &data, int startingField);
+   void parseDiff(std::string_view data, int startingField);
 };
+
+Q_DECLARE_TYPEINFO(CommitInfo, Q_MOVABLE_TYPE);
@@ -0,0 +1,465 @@
+#include "CommitPages.h"
+
+#include <limits>
+
+CommitInfo CommitPages::at(int row) const
+{
+   if (row == 0)
+      return mWip;
+
+   const auto &data = page(row);
+   const auto &stored = data.records.at(index(row));
+   auto text = data.text.constData() + stored.text;
+
+   CommitInfo commit;
+   commit.pos = static_cast<uint>(row);
+   commit.sha = stored.oid.toSha();
+   commit.committer = mIdentities.at(static_cast<int>(stored.committer));
+   commit.author = mIdentities.at(static_cast<int>(stored.author));
+   commit.dateSinceEpoch = std::chrono::seconds(stored.date);
+   commit.shortLog = QString::fromUtf8(text, static_cast<int>(stored.shortLogSize));
+   text += stored.shortLogSize;
+   commit.longLog = QString::fromUtf8(text, static_cast<int>(stored.longLogSize));
+   text += stored.longLogSize;
+   commit.gpgKey = QString::fromUtf8(text, stored.gpgKeySize);
+   commit.mGoodSignature = stored.flags & GoodSignature;
+   commit.mInWorkingBranch = stored.flags & WipChild;
+   commit.mChildsCount = static_cast<int>(stored.childsCount) + (commit.mInWorkingBranch ? 1 : 0);
+
+   if (commit.mInWorkingBranch)
+      commit.mFirstChildRow = 0;
+   else if (stored.firstChild != 0)
+      commit.mFirstChildRow = row - stored.firstChild;
+
+   commit.mParentsSha.reserve(stored.parentsCount);
+
+   for (auto i = 0; i < stored.parentsCount; ++i)
+      commit.mParentsSha.append(data.parents.at(static_cast<int>(stored.parents) + i).oid.toSha());
+
+   return commit;
+}
+
+ObjectId CommitPages::oid(int row) const
+{
+   return row == 0 ? ObjectId() : record(row).oid;
+}
+
+QString CommitPages::shortLog(int row) const
+{
+   return row == 0 ? mWip.shortLog : text(row, 0, record(row).shortLogSize);
+}
+
+QString CommitPages::longLog(int row) const
+{
+   if (row == 0)
+      return mWip.longLog;
+
+   const auto &stored = record(row);
+
+   return text(row, stored.shortLogSize, stored.longLogSize);
+}
+
+const QString &CommitPages::author(int row) const
+{
+   return row == 0 ? mWip.author : mIdentities.at(static_cast<int>(record(row).author));
+}
+
+const QString &CommitPages::committer(int row) const
+{
+   return row == 0 ? mWip.committer : mIdentities.at(static_cast<int>(record(row).committer));
+}
+
+qint64 CommitPages::date(int row) const
+{
+   return row == 0 ? mWip.dateSinceEpoch.count() : record(row).date;
+}
+
+QString CommitPages::gpgKey(int row) const
+{
+   if (row == 0)
+      return mWip.gpgKey;
+
+   const auto &stored = record(row);
+
+   return text(row, stored.shortLogSize + stored.longLogSize, stored.gpgKeySize);
+}
+
+bool CommitPages::isSigned(int row) const
+{
+   return row == 0 ? mWip.isSigned() : record(row).gpgKeySize != 0;
+}
+
+bool CommitPages::verifiedSignature(int row) const
+{
+   return row == 0 ? mWip.verifiedSignature() : (record(row).flags & GoodSignature) && isSigned(row);
+}
+
+bool CommitPages::hasChilds(int row) const
+{
+   if (row == 0)
+      return mWip.hasChilds();
+
+   const auto &stored = record(row);
+
+   return stored.childsCount != 0 || (stored.flags & WipChild);
+}
+
+int CommitPages::parentsCount(int row) const
+{
+   if (row == 0)
+      return mWip.parentsCount();
+
+   static const auto initOid = ObjectId::fromSha(CommitInfo::INIT_SHA);
+   const auto count = parentLinksCount(row);
+
+   for (auto i = 0; i < count; ++i)
+   {
+      if (parent(row, i) == initOid)
+         return count - 1;
+   }
+
+   return count;
+}
+
+int CommitPages::parentLinksCount(int row) const
+{
+   return row == 0 ? mWip.mParentsSha.count() : record(row).parentsCount;
+}
+
+ObjectId CommitPages::parent(int row, int index) const
+{
+   if (row == 0)
+      return ObjectId::fromSha(mWip.mParentsSha.at(index));
+
+   return page(row).parents.at(static_cast<int>(record(row).parents) + index).oid;
+}
+
+int CommitPages::parentRow(int row, int index) const
+{
+   if (row == 0)
+      return index == 0 ? mWipParentRow : -1;
+
+   const auto distance = page(row).parents.at(static_cast<int>(record(row).parents) + index).distance;
+
+   return distance != 0 ? row + distance : -1;
+}
+
+bool CommitPages::contains(int row, const QString &text) const
+{
+   if (row == 0)
+      return mWip.contains(text);
+
+   const auto &data = page(row);
+   const auto &stored = data.records.at(index(row));
+   const auto shortLog
+       = QString::fromUtf8(data.text.constData() + stored.text, static_cast<int>(stored.shortLogSize));
+
+   return stored.oid.toSha().startsWith(text, Qt::CaseInsensitive) || shortLog.contains(text, Qt::CaseInsensitive)
+       || mIdentities.at(static_cast<int>(stored.committer)).contains(text, Qt::CaseInsensitive)
+       || mIdentities.at(static_cast<int>(stored.author)).contains(text, Qt::CaseInsensitive);
+}
+
+void CommitPages::setWip(const CommitInfo &wip)
+{
+   mWip = wip;
+   mWip.pos = 0;
+   mWip.mChildsCount = 0;
+   mWip.mFirstChildRow = -1;
+   mWip.mInWorkingBranch = false;
+   mHasWip = true;
+}
+
+void CommitPages::linkWip(int parentRow)
+{
+   // The page of the parent is only copied when the parent changes.
+   if (parentRow == mWipParentRow)
+      return;
+
+   if (mWipParentRow > 0)
+      record(mWipParentRow).flags &= ~WipChild;
+
+   mWipParentRow = parentRow;
+
+   if (mWipParentRow > 0)
+      record(mWipParentRow).flags |= WipChild;
+}
+
+void CommitPages::append(const CommitInfo &commit)
+{
+   if (mPages.isEmpty() || mPages.constLast()->records.count() == PAGE_SIZE)
+      appendPage();
+
+   appendRecord(*mPages.last(), commit);
+
+   if (mPages.count() == 1)
+      ++mFirstPageSize;
+
+   ++mCount;
+}
+
+void CommitPages::prepend(const QVector<CommitInfo> &commits)
+{
+   // The links are distances between rows: they are still valid after moving all the old rows down. The oldest of the
+   // new commits fill the first page and the rest go to new pages before it.
+   const auto count = commits.count();
+   const auto fitting = mPages.isEmpty() ? 0 : qMin(count, PAGE_SIZE - mFirstPageSize);
+   const auto remaining = count - fitting;
+
+   if (fitting > 0)
+   {
+      auto &first = *mPages.first();
+      const Page old(first);
+
+      first.records.clear();
+      first.records.reserve(old.records.count() + fitting);
+      first.parents.clear();
+      first.text.clear();
+
+      for (auto i = remaining; i < count; ++i)
+         appendRecord(first, commits.at(i));
+
+      for (auto i = 0; i < old.records.count(); ++i)
+         copyRecord(first, old, i);
+
+      mFirstPageSize += fitting;
+   }
+
+   if (remaining > 0)
+   {
+      QVector<QSharedDataPointer<Page>> pages;
+      pages.reserve(((remaining + PAGE_MASK) >> PAGE_BITS) + mPages.count());
+
+      // Only the first of the new pages can be partially filled.
+      auto pageSize = remaining & PAGE_MASK ? remaining & PAGE_MASK : PAGE_SIZE;
+
+      for (auto i = 0; i < remaining; pageSize = PAGE_SIZE)
+      {
+         pages.append(QSharedDataPointer<Page>(new Page()));
+         pages.last()->records.reserve(pageSize);
+
+         for (const auto end = i + pageSize; i < end; ++i)
+            appendRecord(*pages.last(), commits.at(i));
+      }
+
+      mFirstPageSize = pages.constFirst()->records.count();
+
+      pages.append(mPages);
+      mPages = std::move(pages);
+   }
+
+   mCount += count;
+
+   if (mWipParentRow > 0)
+      mWipParentRow += count;
+}
+
+void CommitPages::replace(int row, const CommitInfo &commit)
+{
+   // The texts and the parents of a commit are stored after the ones of the previous commit of the page, so the page
+   // is written again.
+   const auto replaced = index(row);
+   auto &data = page(row);
+   const Page old(data);
+   const auto &kept = old.records.at(replaced);
+
+   data.records.clear();
+   data.records.reserve(old.records.count());
+   data.parents.clear();
+   data.parents.reserve(old.parents.count());
+   data.text.clear();
+   data.text.reserve(old.text.size());
+
+   for (auto i = 0; i < old.records.count(); ++i)
+   {
+      if (i != replaced)
+         copyRecord(data, old, i);
+      else
+      {
+         appendRecord(data, commit);
+
+         auto &stored = data.records.last();
+         stored.flags |= kept.flags & WipChild;
+         stored.childsCount = kept.childsCount;
+         stored.firstChild = kept.firstChild;
+      }
+   }
+}
+
+void CommitPages::linkParent(int row, const ObjectId &parent, int parentRow)
+{
+   if (row <= 0 || parentRow <= row)
+      return;
+
+   auto &data = page(row);
+   const auto &stored = data.records.at(index(row));
+   const auto first = static_cast<int>(stored.parents);
+
+   for (auto i = first; i < first + stored.parentsCount; ++i)
+   {
+      if (auto &link = data.parents[i]; link.oid == parent && link.distance == 0)
+      {
+         link.distance = parentRow - row;
+
+         if (auto &parentRecord = record(parentRow); parentRecord.childsCount++ == 0)
+            parentRecord.firstChild = parentRow - row;
+
+         return;
+      }
+   }
+}
+
+void CommitPages::unlinkParents(int row)
+{
+   if (row <= 0)
+      return;
+
+   const auto count = parentLinksCount(row);
+
+   for (auto i = 0; i < count; ++i)
+   {
+      const auto parentRow = this->parentRow(row, i);
+
+      if (parentRow == -1)
+         continue;
+
+      auto &data = page(row);
+      data.parents[static_cast<int>(data.records.at(index(row)).parents) + i].distance = 0;
+
+      auto &parentRecord = record(parentRow);
+
+      if (--parentRecord.childsCount == 0)
+         parentRecord.firstChild = 0;
+      else if (parentRecord.firstChild == parentRow - row)
+         parentRecord.firstChild = parentRow - firstChild(parentRow, row);
+   }
+}
+
+void CommitPages::reserve(int count)
+{
+   mPages.reserve((count + PAGE_MASK) >> PAGE_BITS);
+}
+
+void CommitPages::clear()
+{
+   mPages.clear();
+   mPages.squeeze();
+   mFirstPageSize = 0;
+   mCount = 0;
+   mHasWip = false;
+   mWip = CommitInfo();
+   mWipParentRow = -1;
+   mIdentities.clear();
+   mIdentities.squeeze();
+   mIdentityIds.clear();
+   mIdentityIds.squeeze();
+}
+
+std::pair<int, int> CommitPages::locate(int row) const
+{
+   // The WIP is not in the pages.
+   const auto position = row - 1;
+
+   if (position < mFirstPageSize)
+      return { 0, position };
+
+   const auto rest = position - mFirstPageSize;
+
+   return { 1 + (rest >> PAGE_BITS), rest & PAGE_MASK };
+}
+
+QString CommitPages::text(int row, quint32 offset, quint32 size) const
+{
+   const auto &data = page(row);
+
+   return QString::fromUtf8(data.text.constData() + data.records.at(index(row)).text + offset, static_cast<int>(size));
+}
+
+const CommitPages::Record &CommitPages::record(int row) const
+{
+   return page(row).records.at(index(row));
+}
+
+CommitPages::Record &CommitPages::record(int row)
+{
+   return page(row).records[index(row)];
+}
+
+quint32 CommitPages::identity(const QString &name)
+{
+   if (const auto iter = mIdentityIds.constFind(name); iter != mIdentityIds.cend())
+      return iter.value();
+
+   const auto id = static_cast<quint32>(mIdentities.count());
+
+   mIdentities.append(name);
+   mIdentityIds.insert(name, id);
+
+   return id;
+}
+
+void CommitPages::appendRecord(Page &page, const CommitInfo &commit)
+{
+   const auto shortLog = commit.shortLog.toUtf8();
+   const auto longLog = commit.longLog.toUtf8();
+   const auto gpgKey = commit.gpgKey.toUtf8().left(std::numeric_limits<quint8>::max());
+
+   Record stored;
+   stored.oid = ObjectId::fromSha(commit.sha);
+   stored.parentsCount = static_cast<quint16>(commit.mParentsSha.count());
+   stored.flags = commit.mGoodSignature ? GoodSignature : 0;
+   stored.gpgKeySize = static_cast<quint8>(gpgKey.size());
+   stored.committer = identity(commit.committer);
+   stored.author = identity(commit.author);
+   stored.parents = static_cast<quint32>(page.parents.count());
+   stored.text = static_cast<quint32>(page.text.size());
+   stored.shortLogSize = static_cast<quint32>(shortLog.size());
+   stored.longLogSize = static_cast<quint32>(longLog.size());
+   stored.childsCount = 0;
+   stored.firstChild = 0;
+   stored.date = commit.dateSinceEpoch.count();
+
+   for (const auto &parent : commit.mParentsSha)
+      page.parents.append(Link { ObjectId::fromSha(parent), 0 });
+
+   page.text.append(shortLog).append(longLog).append(gpgKey);
+   page.records.append(stored);
+}
+
+void CommitPages::copyRecord(Page &page, const Page &source, int index)
+{
+   auto stored = source.records.at(index);
+   const auto textSize = static_cast<int>(stored.shortLogSize + stored.longLogSize + stored.gpgKeySize);
+
+   page.text.append(source.text.constData() + stored.text, textSize);
+   page.parents.append(source.parents.mid(static_cast<int>(stored.parents), stored.parentsCount));
+
+   stored.parents = static_cast<quint32>(page.parents.count() - stored.parentsCount);
+   stored.text = static_cast<quint32>(page.text.size() - textSize);
+
+   page.records.append(stored);
+}
+
+void CommitPages::appendPage()
+{
+   mPages.append(QSharedDataPointer<Page>(new Page()));
+   mPages.last()->records.reserve(PAGE_SIZE);
+   mPages.last()->parents.reserve(PAGE_SIZE);
+}
+
+int CommitPages::firstChild(int row, int excludedChild) const
+{
+   // The children are always above their parents.
+   for (auto child = 1; child < row; ++child)
+   {
+      if (child == excludedChild)
+         continue;
+
+      for (auto i = 0; i < parentLinksCount(child); ++i)
+      {
+         if (parentRow(child, i) == row)
+            return child;
+      }
+   }
+
+   return row;
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <ObjectId.h>
+
+#include <QHash>
+#include <QSharedData>
+#include <QVector>
+
+#include <utility>
+
+/**
+ * @brief The CommitPages class stores the commits of the history by columns instead of as a list of CommitInfo. The
+ * SHAs are kept as binary ids, the parents are linked by the distance to their rows, the authors and committers are
+ * stored once and referenced by an index and the messages are kept in UTF-8 in a buffer per page. The commits are
+ * built again as a CommitInfo when they are read with @ref at. The readers that only need some fields, like the views
+ * that paint the history, read them from their column instead.
+ *
+ * The commits are stored in pages that are implicitly shared. A copy only costs a reference per page, and a page is
+ * only copied when it's modified while another copy is alive. That lets the cache publish a new version of the history
+ * after every change without copying all of it. All the pages are full except the first and the last ones: the new
+ * commits are added on top of the first page or at the end of the last one, so only those are copied.
+ *
+ * The WIP is always the first row and it's stored apart from the pages, since it's the commit that changes the most.
+ *
+ * @class CommitPages CommitPages.h "CommitPages.h"
+ */
+class CommitPages
+{
+public:
+   int count() const { return mCount + (mHasWip ? 1 : 0); }
+   bool isEmpty() const { return count() == 0; }
+   bool hasWip() const { return mHasWip; }
+
+   /**
+    * @brief Builds the commit stored in @p row, with its position and the number of children it has.
+    */
+   CommitInfo at(int row) const;
+   CommitInfo constFirst() const { return at(0); }
+
+   ObjectId oid(int row) const;
+   QString sha(int row) const { return oid(row).toSha(); }
+
+   /**
+    * @brief Returns the subject of the commit in @p row. Only the subject is decoded.
+    */
+   QString shortLog(int row) const;
+
+   /**
+    * @brief Returns the body of the commit in @p row. Only the body is decoded.
+    */
+   QString longLog(int row) const;
+
+   /**
+    * @brief Returns the author of the commit in @p row, with the name and the email. It's stored once per identity, so
+    * nothing is copied.
+    */
+   const QString &author(int row) const;
+
+   /**
+    * @brief Same as @ref author for the committer.
+    */
+   const QString &committer(int row) const;
+
+   /**
+    * @brief Returns the date of the commit in @p row, in seconds since the epoch.
+    */
+   qint64 date(int row) const;
+
+   /**
+    * @brief Returns the GPG key of the commit in @p row, or an empty string if it's not signed.
+    */
+   QString gpgKey(int row) const;
+
+   /**
+    * @brief Same as CommitInfo::isSigned without building the commit.
+    */
+   bool isSigned(int row) const;
+
+   /**
+    * @brief Same as CommitInfo::verifiedSignature without building the commit.
+    */
+   bool verifiedSignature(int row) const;
+
+   /**
+    * @brief Same as CommitInfo::hasChilds without building the commit.
+    */
+   bool hasChilds(int row) const;
+
+   /**
+    * @brief Returns the number of parents of the commit in @p row, without the empty tree. Same as
+    * CommitInfo::parentsCount.
+    */
+   int parentsCount(int row) const;
+
+   /**
+    * @brief Returns the number of parents stored for the commit in @p row, including the empty tree.
+    */
+   int parentLinksCount(int row) const;
+   ObjectId parent(int row, int index) const;
+
+   /**
+    * @brief Returns the row of the parent in the position @p index of the commit in @p row, or -1 if it's not loaded.
+    */
+   int parentRow(int row, int index) const;
+
+   /**
+    * @brief Checks if the SHA of the commit in @p row starts with @p text or its subject, author or committer contains
+    * it. Same as CommitInfo::contains without building the commit.
+    */
+   bool contains(int row, const QString &text) const;
+
+   /**
+    * @brief Sets the WIP commit in the first row. Its children and the link to its parent are not changed.
+    */
+   void setWip(const CommitInfo &wip);
+
+   /**
+    * @brief Links the WIP to the row of its parent, or unlinks it if @p parentRow is -1.
+    */
+   void linkWip(int parentRow);
+   int wipParentRow() const { return mWipParentRow; }
+
+   /**
+    * @brief Appends a commit at the end of the history. Its parents are not linked: @ref linkParent must be called
+    * when they are loaded.
+    */
+   void append(const CommitInfo &commit);
+
+   /**
+    * @brief Inserts @p commits after the WIP, on top of the history. The parents of the new commits are not linked.
+    * Only the first page is copied: the commits that don't fit in it are stored in new pages.
+    */
+   void prepend(const QVector<CommitInfo> &commits);
+
+   /**
+    * @brief Replaces the commit in @p row, keeping its children. Its parents must be unlinked before with
+    * @ref unlinkParents and the new ones linked after.
+    */
+   void replace(int row, const CommitInfo &commit);
+
+   /**
+    * @brief Links the parent @p parent of the commit in @p row with the commit in @p parentRow, that counts it as its
+    * child.
+    */
+   void linkParent(int row, const ObjectId &parent, int parentRow);
+
+   /**
+    * @brief Removes the commit in @p row from the children of all its parents.
+    */
+   void unlinkParents(int row);
+
+   void reserve(int count);
+   void clear();
+
+   // How a commit is stored. They are only public so they can be declared as primitive types.
+   enum Flag : quint8
+   {
+      GoodSignature = 1,
+      WipChild = 2
+   };
+
+   struct Record
+   {
+      ObjectId oid;
+      quint16 parentsCount;
+      quint8 flags;
+      quint8 gpgKeySize;
+      quint32 committer;
+      quint32 author;
+      // Offsets of the first parent in the links of the page and of the subject in the texts of the page. The body
+      // and the GPG key follow the subject.
+      quint32 parents;
+      quint32 text;
+      quint32 shortLogSize;
+      quint32 longLogSize;
+      // The children are not stored: only how many of them there are and the distance up to the first one.
+      quint32 childsCount;
+      qint32 firstChild;
+      qint64 date;
+   };
+
+   struct Link
+   {
+      ObjectId oid;
+      // Number of rows from the child down to the parent. Zero while the parent is not loaded.
+      qint32 distance;
+   };
+
+private:
+   static const int PAGE_BITS = 10;
+   static const int PAGE_SIZE = 1 << PAGE_BITS;
+   static const int PAGE_MASK = PAGE_SIZE - 1;
+
+   struct Page : QSharedData
+   {
+      QVector<Record> records;
+      QVector<Link> parents;
+      QByteArray text;
+   };
+
+   QVector<QSharedDataPointer<Page>> mPages;
+   int mFirstPageSize = 0;
+   int mCount = 0;
+   bool mHasWip = false;
+   CommitInfo mWip;
+   int mWipParentRow = -1;
+   QVector<QString> mIdentities;
+   QHash<QString, quint32> mIdentityIds;
+
+   std::pair<int, int> locate(int row) const;
+   int index(int row) const { return locate(row).second; }
+   const Record &record(int row) const;
+   Record &record(int row);
+   const Page &page(int row) const { return *mPages.at(locate(row).first); }
+   Page &page(int row) { return *mPages[locate(row).first]; }
+   QString text(int row, quint32 offset, quint32 size) const;
+   quint32 identity(const QString &name);
+   void appendRecord(Page &page, const CommitInfo &commit);
+   static void copyRecord(Page &page, const Page &source, int index);
+   void appendPage();
+   int firstChild(int row, int excludedChild) const;
+};
+
+Q_DECLARE_TYPEINFO(CommitPages::Record, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(CommitPages::Link, Q_PRIMITIVE_TYPE);
@@ -0,0 +1,166 @@
+#include "CommitSearchIndex.h"
+
+#include <CommitInfo.h>
+
+#include <algorithm>
+
+namespace
+{
+const int EXACT_MATCH_SCORE = 2;
+const int SUBJECT_SCORE = 1;
+}
+
+void CommitSearchIndex::clear()
+{
+   mShas.clear();
+   mShas.squeeze();
+   mTerms.clear();
+}
+
+void CommitSearchIndex::reserve(int count)
+{
+   mShas.reserve(count);
+}
+
+void CommitSearchIndex::insert(const CommitInfo &commit)
+{
+   const auto document = static_cast<quint32>(mShas.count());
+
+   mShas.append(commit.sha);
+
+   insertWords(commit.shortLog, document, Subject);
+   insertWords(commit.author, document, Identity);
+
+   if (commit.committer != commit.author)
+      insertWords(commit.committer, document, Identity);
+}
+
+void CommitSearchIndex::remove(const QString &sha)
+{
+   // The postings of the commit are kept but they are skipped in the searches. The SHA isn't a key of the index so it
+   // can only be found from the end: the commits removed are the last ones added.
+   for (auto i = mShas.count() - 1; i >= 0; --i)
+   {
+      if (mShas.at(i) == sha)
+      {
+         mShas[i].clear();
+         break;
+      }
+   }
+}
+
+QVector<CommitSearchIndex::Hit> CommitSearchIndex::search(const QString &text) const
+{
+   // The documents and their scores are kept sorted by document so the results of every word are intersected linearly.
+   QVector<QPair<quint32, int>> results;
+   auto firstWord = true;
+
+   for (const auto &word : words(text))
+   {
+      QVector<quint32> postings;
+
+      for (auto iter = mTerms.lowerBound(word); iter != mTerms.cend() && iter.key().startsWith(word); ++iter)
+      {
+         const auto exact = iter.key().length() == word.length() ? 0x4u : 0x0u;
+
+         for (const auto posting : iter.value())
+            postings.append(((posting >> FIELD_BITS) << 3) | (posting & Fields) | exact);
+      }
+
+      std::sort(postings.begin(), postings.end());
+
+      QVector<QPair<quint32, int>> matches;
+      matches.reserve(postings.count());
+
+      for (const auto posting : qAsConst(postings))
+      {
+         const auto document = posting >> 3;
+         const auto score = ((posting & 0x4) ? EXACT_MATCH_SCORE : 0) + ((posting & Subject) ? SUBJECT_SCORE : 0);
+
+         if (!matches.isEmpty() && matches.constLast().first == document)
+            matches.last().second = std::max(matches.constLast().second, score);
+         else
+            matches.append(qMakePair(document, score));
+      }
+
+      if (firstWord)
+      {
+         results = std::move(matches);
+         firstWord = false;
+      }
+      else
+      {
+         QVector<QPair<quint32, int>> intersection;
+         auto result = results.cbegin();
+         auto match = matches.cbegin();
+
+         while (result != results.cend() && match != matches.cend())
+         {
+            if (result->first < match->first)
+               ++result;
+            else if (match->first < result->first)
+               ++match;
+            else
+            {
+               intersection.append(qMakePair(result->first, result->second + match->second));
+               ++result;
+               ++match;
+            }
+         }
+
+         results = std::move(intersection);
+      }
+
+      if (results.isEmpty())
+         break;
+   }
+
+   QVector<Hit> hits;
+   hits.reserve(results.count());
+
+   for (const auto &result : qAsConst(results))
+   {
+      if (const auto &sha = mShas.at(static_cast<int>(result.first)); !sha.isEmpty())
+         hits.append({ sha, result.second });
+   }
+
+   return hits;
+}
+
+void CommitSearchIndex::insertWords(const QString &text, quint32 document, Field field)
+{
+   const auto posting = (document << FIELD_BITS) | field;
+
+   for (const auto &word : words(text))
+   {
+      auto &postings = mTerms[word];
+
+      // The same word can appear several times in the same commit: the fields are merged in its last posting.
+      if (!postings.isEmpty() && (postings.constLast() >> FIELD_BITS) == document)
+         postings.last() |= field;
+      else
+         postings.append(posting);
+   }
+}
+
+QVector<QString> CommitSearchIndex::words(const QString &text)
+{
+   QVector<QString> words;
+   auto start = -1;
+
+   for (auto i = 0; i <= text.length(); ++i)
+   {
+      if (i < text.length() && text.at(i).isLetterOrNumber())
+      {
+         if (start == -1)
+            start = i;
+      }
+      else if (start != -1)
+      {
+         words.append(text.mid(start, i - start).toLower());
+         start = -1;
+      }
+   }
+
+   return words;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+class CommitInfo;
+
+/**
+ * @brief The CommitSearchIndex class is an inverted index of the words in the subject, author and committer of the
+ * commits. It finds all the commits that contain words starting with the words searched without going through all the
+ * commits of the repository.
+ *
+ * The class is not thread safe: it's protected by the cache that owns it.
+ *
+ * @class CommitSearchIndex CommitSearchIndex.h "CommitSearchIndex.h"
+ */
+class CommitSearchIndex
+{
+public:
+   /**
+    * @brief The Hit struct is a commit that matches a search. The higher the score, the better the match.
+    */
+   struct Hit
+   {
+      QString sha;
+      int score = 0;
+   };
+
+   /**
+    * @brief Removes all the commits from the index.
+    */
+   void clear();
+
+   /**
+    * @brief Reserves memory for @p count commits.
+    */
+   void reserve(int count);
+
+   /**
+    * @brief Adds the words of a commit to the index.
+    */
+   void insert(const CommitInfo &commit);
+
+   /**
+    * @brief Removes the commit with the given SHA from the results of the index.
+    */
+   void remove(const QString &sha);
+
+   /**
+    * @brief Finds the commits that have, for every word in @p text, a word that starts with it. Words fully matched
+    * and words in the subject score higher than partial matches and words of the author or committer.
+    * @param text The text to search.
+    * @return The commits found, in no particular order.
+    */
+   QVector<Hit> search(const QString &text) const;
+
+private:
+   // Every posting contains the document and the fields where the word was found in the lower bits.
+   enum Field : quint32
+   {
+      Subject = 0x1,
+      Identity = 0x2,
+      Fields = 0x3
+   };
+
+   static const int FIELD_BITS = 2;
+
+   QVector<QString> mShas;
+   QMap<QString, QVector<quint32>> mTerms;
+
+   void insertWords(const QString &text, quint32 document, Field field);
+   static QVector<QString> words(const QString &text);
+};
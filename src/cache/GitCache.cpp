@@ -3,13 +3,25 @@
 #include <QLogger.h>
 #include <WipRevisionInfo.h>
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+
 using namespace QLogger;
 
+static const auto LANES_CHECKPOINT_INTERVAL = 256;
+static const auto LANES_CACHE_ROWS = 4096;
+static const auto REVISION_FILES_BUDGET = 64 * 1024 * 1024;
+static const auto PREFETCH_NEIGHBOURS = 8;
+
 GitCache::GitCache(QObject *parent)
    : QObject(parent)
    , mCommitsMutex(QMutex::Recursive)
+   , mLanesCache(LANES_CACHE_ROWS)
    , mRevisionsMutex(QMutex::Recursive)
+   , mRevisionFilesMap(REVISION_FILES_BUDGET)
    , mReferencesMutex(QMutex::Recursive)
+   , mRenderState(std::make_shared<RenderState>())
 {
 }
 
@@ -18,171 +30,778 @@ GitCache::~GitCache()
    clearInternalData();
 }
 
+template<typename Update>
+void GitCache::updateRenderState(Update update)
+{
+   // The writers are serialized so none of them loses the changes of another. The readers never lock.
+   QMutexLocker lock(&mRenderStateMutex);
+
+   auto state = std::make_shared<RenderState>(*std::atomic_load(&mRenderState));
+   update(*state);
+
+   std::atomic_store(&mRenderState, std::shared_ptr<const RenderState>(std::move(state)));
+}
+
+void GitCache::publishCommits()
+{
+   // Only the pages of the commits modified since the last version are copied by the next change.
+   updateRenderState([this](RenderState &state) {
+      state.commits = mCommits;
+      state.lanesCheckpoints = mLanesCheckpoints;
+      state.lanesVersion = mLanesVersion;
+      state.rowShift = mRowShift;
+   });
+}
+
+void GitCache::publishReferences()
+{
+   updateRenderState([this](RenderState &state) { state.references = mReferences; });
+}
+
 void GitCache::setup(const QString &parentSha, const RevisionFiles &files, QVector<CommitInfo> commits)
 {
    QMutexLocker lock(&mCommitsMutex);
 
+   startSetup(parentSha, commits.count());
+   appendCommits(std::move(commits));
+   finishSetup(parentSha, files);
+}
+
+void GitCache::startSetup(const QString &parentSha, int expectedCommits)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
    mInitialized = true;
 
-   const auto totalCommits = commits.count() + 1;
+   const auto totalCommits = expectedCommits + 1;
 
    QLog_Debug("Cache", QString("Configuring the cache for {%1} elements.").arg(totalCommits));
 
    mConfigured = false;
 
    mCommits.clear();
-   mCommits.squeeze();
    mCommitsMap.clear();
    mCommitsMap.squeeze();
-   mUntrackedFiles.clear();
-   mUntrackedFiles.squeeze();
+   mRowShift = 0;
+   mGenerations.clear();
+   mGenerations.squeeze();
+   mShaIndex.clear();
+   mTmpChildsStorage.clear();
+   mTmpChildsStorage.squeeze();
+   mSubtrees.clear();
+   mLanesCheckpoints.clear();
+   mLanesCheckpoints.squeeze();
    mLanes.clear();
+   invalidateLanes();
+   resetSearchIndex();
 
    mCommitsMap.reserve(totalCommits);
-   mCommits.resize(totalCommits);
+   mShaIndex.reserve(totalCommits);
+   mCommits.reserve(totalCommits);
 
    QLog_Debug("Cache", QString("Adding WIP revision."));
 
-   insertWipRevision(parentSha, files);
+   // The files of the WIP are not known yet. They are set when the setup finishes but the parent is needed now so the
+   // lanes of the commits that follow can be calculated.
+   insertWipRevision(parentSha, RevisionFiles());
+}
 
-   QLog_Debug("Cache", QString("Adding committed revisions."));
+void GitCache::appendCommits(QVector<CommitInfo> commits)
+{
+   QMutexLocker lock(&mCommitsMutex);
 
-   QHash<QString, QVector<CommitInfo *>> tmpChildsStorage;
-   auto count = 0;
+   QLog_Debug("Cache", QString("Adding {%1} committed revisions.").arg(commits.count()));
 
-   for (auto &commit : commits)
+   const auto wipParent = mCommits.parentLinksCount(0) > 0 ? mCommits.parent(0, 0) : ObjectId();
+
+   for (const auto &commit : qAsConst(commits))
    {
-      calculateLanes(commit);
+      auto valid = false;
+      const auto oid = ObjectId::fromSha(commit.sha, &valid);
+
+      if (!valid || mCommitsMap.contains(oid))
+         continue;
 
-      const auto sha = commit.sha;
+      const auto row = mCommits.count();
 
-      if (sha == mCommitsMap.value(CommitInfo::ZERO_SHA).firstParent())
-         commit.appendChild(&mCommitsMap[CommitInfo::ZERO_SHA]);
+      // The history is loaded from the newest commit: the subtrees keep the first split found.
+      indexSubtree(commit, false);
 
-      mCommitsMap[sha] = commit;
-      mCommits[++count] = &mCommitsMap[sha];
+      mCommits.append(commit);
+      mapRow(oid, row);
+      mShaIndex.insert(commit.sha);
 
-      if (tmpChildsStorage.contains(sha))
+      if (oid == wipParent)
+         mCommits.linkWip(row);
+
+      // The children are always stored before their parents: they are linked once the parent is loaded.
+      if (const auto childs = mTmpChildsStorage.find(oid); childs != mTmpChildsStorage.end())
       {
-         for (const auto &child : qAsConst(tmpChildsStorage[sha]))
-            mCommitsMap[sha].appendChild(child);
+         for (const auto child : qAsConst(childs.value()))
+            mCommits.linkParent(child, oid, row);
 
-         tmpChildsStorage.remove(sha);
+         mTmpChildsStorage.erase(childs);
       }
 
-      for (const auto &parent : qAsConst(mCommitsMap[sha].mParentsSha))
-         tmpChildsStorage[parent].append(&mCommitsMap[sha]);
+      for (auto i = 0; i < mCommits.parentLinksCount(row); ++i)
+         mTmpChildsStorage[mCommits.parent(row, i)].append(row);
+
+      // Only the state of the lanes is calculated here. The lanes of every row are calculated from the checkpoints when
+      // they are needed.
+      if (row % LANES_CHECKPOINT_INTERVAL == 0)
+         mLanesCheckpoints.append(qMakePair(row, mLanes));
+
+      calculateLanes(mLanes, mCommits, row);
    }
 
+   publishCommits();
+}
+
+void GitCache::finishSetup(const QString &parentSha, const RevisionFiles &files)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   QLog_Debug("Cache", QString("Finishing the cache setup with {%1} elements.").arg(mCommits.count()));
+
+   insertWipRevision(parentSha, files);
+   mShaIndex.sort();
+   updateGenerations(0, mCommits.count() - 1);
+
    mCommitsMap.squeeze();
-   mCommits.squeeze();
 
-   tmpChildsStorage.clear();
-   tmpChildsStorage.squeeze();
+   mTmpChildsStorage.clear();
+   mTmpChildsStorage.squeeze();
+}
+
+int GitCache::insertCommits(QVector<CommitInfo> commits, const QString &wipParentSha, int &changedRows)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   commits.erase(std::remove_if(commits.begin(), commits.end(),
+                                [this](const CommitInfo &commit) { return rowOf(commit.sha) != -1; }),
+                 commits.end());
+
+   const auto count = commits.count();
+
+   QLog_Debug("Cache", QString("Inserting {%1} new revisions on top of the history.").arg(count));
+
+   shiftRows(count);
+
+   mCommits.prepend(commits);
+
+   if (!mGenerations.isEmpty())
+      mGenerations.insert(1, count, 0U);
+
+   for (auto i = 0; i < count; ++i)
+   {
+      const auto &commit = commits.at(i);
+
+      mapRow(ObjectId::fromSha(commit.sha), i + 1);
+      mShaIndex.insert(commit.sha);
+      updateSearchIndex(true, commit);
+   }
+
+   // The new commits are more recent than the ones already indexed: the oldest of them are indexed first.
+   for (auto i = count - 1; i >= 0; --i)
+      indexSubtree(commits.at(i), true);
+
+   for (auto row = 1; row <= count; ++row)
+   {
+      for (auto i = 0; i < mCommits.parentLinksCount(row); ++i)
+      {
+         const auto parent = mCommits.parent(row, i);
+
+         if (const auto parentRow = rowOf(parent); parentRow != -1)
+            mCommits.linkParent(row, parent, parentRow);
+      }
+   }
+
+   if (auto wip = mCommits.constFirst(); wip.firstParent() != wipParentSha)
+   {
+      wip.mParentsSha = QStringList { wipParentSha };
+      mCommits.setWip(wip);
+   }
+
+   mCommits.linkWip(rowOf(wipParentSha));
+
+   changedRows = recalculateLanes(count);
+   updateGenerations(0, count);
+   publishCommits();
+
+   return count;
+}
+
+int GitCache::recalculateLanes(int insertedRows)
+{
+   // The lanes of a row only depend on the state of the lanes before it and the rows below. Once the new state matches
+   // the one stored for an old row, the rest of the graph is the same as before and the calculation stops there. The
+   // checkpoints were already moved to the new positions of their rows.
+   const auto oldCheckpoints = mLanesCheckpoints;
+   auto oldCheckpoint = oldCheckpoints.cbegin();
+   const auto finalLanes = mLanes;
+   const auto total = mCommits.count();
+   auto row = 0;
+
+   mLanesCheckpoints.clear();
+   mLanes.clear();
+   mLanes.init(Lanes::shaId(CommitInfo::ZERO_SHA));
+   invalidateLanes();
+
+   for (; row < total; ++row)
+   {
+      while (oldCheckpoint != oldCheckpoints.cend() && oldCheckpoint->first < row)
+         ++oldCheckpoint;
+
+      if (row > insertedRows && oldCheckpoint != oldCheckpoints.cend() && oldCheckpoint->first == row
+          && oldCheckpoint->second == mLanes)
+         break;
+
+      if (row % LANES_CHECKPOINT_INTERVAL == 0)
+         mLanesCheckpoints.append(qMakePair(row, mLanes));
+
+      calculateLanes(mLanes, mCommits, row);
+   }
+
+   QLog_Debug("Cache", QString("Lanes recalculated for {%1} of {%2} rows.").arg(row).arg(total));
+
+   if (row < total)
+   {
+      for (; oldCheckpoint != oldCheckpoints.cend(); ++oldCheckpoint)
+         mLanesCheckpoints.append(*oldCheckpoint);
+
+      mLanes = finalLanes;
+   }
+
+   return row;
+}
+
+void GitCache::shiftRows(int count)
+{
+   // Moves all the rows after the WIP down. Neither the commits nor the map are modified: the commits don't store
+   // their position, their parents are linked by the distance to them and the map is corrected by the shift. Only the
+   // lanes checkpoints are moved.
+   mRowShift += count;
+
+   for (auto &checkpoint : mLanesCheckpoints)
+   {
+      if (checkpoint.first > 0)
+         checkpoint.first += count;
+   }
+
+   invalidateLanes();
+}
+
+QString GitCache::commitSha(int row) const
+{
+   const auto state = renderState();
+
+   return row >= 0 && row < state->commits.count() ? state->commits.sha(row) : QString();
 }
 
-CommitInfo GitCache::commitInfo(int row)
+int GitCache::commitRow(const QString &sha) const
 {
    QMutexLocker lock(&mCommitsMutex);
 
-   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+   return findRow(sha);
+}
 
-   return commit ? *commit : CommitInfo();
+QString GitCache::commitShortLog(const QString &sha) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   const auto row = findRow(sha);
+
+   return row != -1 ? mCommits.shortLog(row) : QString();
 }
 
-auto GitCache::searchCommit(const QString &text, const int startingPoint) const
+int GitCache::searchCommit(const QString &text, const int startingPoint) const
 {
-   return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
-                       [text](CommitInfo *info) { return info->contains(text); });
+   for (auto row = startingPoint; row < mCommits.count(); ++row)
+   {
+      if (mCommits.contains(row, text))
+         return row;
+   }
+
+   return -1;
 }
 
-auto GitCache::reverseSearchCommit(const QString &text, int startingPoint) const
+int GitCache::reverseSearchCommit(const QString &text, int startingPoint) const
 {
    const auto startEndPos = startingPoint > 0 ? mCommits.count() - startingPoint + 1 : 0;
 
-   return std::find_if(mCommits.crbegin() + startEndPos, mCommits.crend(),
-                       [text](CommitInfo *info) { return info->contains(text); });
+   for (auto row = mCommits.count() - 1 - startEndPos; row >= 0; --row)
+   {
+      if (mCommits.contains(row, text))
+         return row;
+   }
+
+   return -1;
 }
 
 CommitInfo GitCache::searchCommitInfo(const QString &text, int startingPoint, bool reverse)
 {
    QMutexLocker lock(&mCommitsMutex);
-   CommitInfo commit;
 
-   if (!reverse)
+   auto row = reverse ? reverseSearchCommit(text, startingPoint) : searchCommit(text, startingPoint);
+
+   if (row == -1)
+      row = reverse ? reverseSearchCommit(text) : searchCommit(text);
+
+   return row != -1 ? mCommits.at(row) : CommitInfo();
+}
+
+std::optional<QStringList> GitCache::searchCommits(const QString &text) const
+{
+   QVector<CommitSearchIndex::Hit> hits;
+
    {
-      auto commitIter = searchCommit(text, startingPoint);
+      QMutexLocker lock(&mSearchIndexMutex);
 
-      if (commitIter == mCommits.constEnd())
-         commitIter = searchCommit(text);
+      if (!mSearchIndexReady)
+         return std::nullopt;
 
-      if (commitIter != mCommits.constEnd())
-         commit = **commitIter;
+      hits = mSearchIndex.search(text);
    }
-   else
+
+   QMutexLocker lock(&mCommitsMutex);
+
+   // The score of every row found. The SHAs that start with the text are the best possible match.
+   QHash<int, int> scores;
+
+   for (const auto &sha : mShaIndex.findAll(text.trimmed()))
+   {
+      if (const auto row = rowOf(sha); row != -1)
+         scores.insert(row, std::numeric_limits<int>::max());
+   }
+
+   for (const auto &hit : qAsConst(hits))
    {
-      auto commitIter = reverseSearchCommit(text, startingPoint);
+      if (const auto row = rowOf(hit.sha); row != -1 && !scores.contains(row))
+         scores.insert(row, hit.score);
+   }
+
+   QVector<QPair<int, int>> ranking;
+   ranking.reserve(scores.count());
+
+   for (auto iter = scores.cbegin(); iter != scores.cend(); ++iter)
+      ranking.append(qMakePair(-iter.value(), iter.key()));
+
+   // Same score: the newest commits first.
+   std::sort(ranking.begin(), ranking.end());
+
+   QStringList shas;
+   shas.reserve(ranking.count());
+
+   for (const auto &rank : qAsConst(ranking))
+      shas.append(mCommits.sha(rank.second));
+
+   return shas;
+}
+
+QVector<int> GitCache::commitRows(const QStringList &shas, int rowShift) const
+{
+   QMutexLocker lock(&mCommitsMutex);
 
-      if (commitIter == mCommits.crend())
-         commitIter = reverseSearchCommit(text);
+   QVector<int> rows;
+   rows.reserve(shas.count());
 
-      if (commitIter != mCommits.crend())
-         commit = **commitIter;
+   // The rows after the WIP of an older version are above the current ones. The commits inserted after it end up over
+   // the WIP.
+   const auto offset = mRowShift - rowShift;
+
+   for (const auto &sha : shas)
+   {
+      if (const auto row = rowOf(sha); row == 0)
+         rows.append(row);
+      else if (row != -1 && row - offset > 0)
+         rows.append(row - offset);
    }
 
-   return commit;
+   std::sort(rows.begin(), rows.end());
+   rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+   return rows;
+}
+
+std::optional<QStringList> GitCache::pathHistory(const QString &path) const
+{
+   auto relativePath = path.trimmed();
+
+   while (relativePath.endsWith('/'))
+      relativePath.chop(1);
+
+   QMutexLocker lock(&mChangedPathsMutex);
+
+   if (!mChangedPathsReady)
+      return std::nullopt;
+
+   QMutexLocker commitsLock(&mCommitsMutex);
+
+   // Every path followed only takes the commits below the row where the file got its next name.
+   QVector<QPair<QString, int>> pending { qMakePair(relativePath, -1) };
+   QSet<QString> followed { relativePath };
+   QVector<int> rows;
+
+   while (!pending.isEmpty())
+   {
+      const auto current = pending.takeLast();
+
+      for (const auto &sha : mChangedPaths.commits(current.first))
+      {
+         if (const auto row = rowOf(sha); row > current.second)
+            rows.append(row);
+      }
+
+      for (const auto &rename : mChangedPaths.renames(current.first))
+      {
+         if (const auto row = rowOf(rename.first);
+             row > current.second && !followed.contains(rename.second))
+         {
+            followed.insert(rename.second);
+            pending.append(qMakePair(rename.second, row));
+         }
+      }
+   }
+
+   std::sort(rows.begin(), rows.end());
+   rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+   QStringList shas;
+   shas.reserve(rows.count());
+
+   for (const auto row : qAsConst(rows))
+      shas.append(mCommits.sha(row));
+
+   return shas;
 }
 
 bool GitCache::isCommitInCurrentGeneologyTree(const QString &sha)
 {
    QMutexLocker lock(&mCommitsMutex);
 
-   return checkSha(sha, CommitInfo::ZERO_SHA);
+   const auto row = rowOf(sha);
+
+   return row != -1 && isAncestorRow(row, 0);
 }
 
-CommitInfo GitCache::commitInfo(const QString &sha)
+std::optional<bool> GitCache::isAncestor(const QString &ancestorSha, const QString &sha)
 {
    QMutexLocker lock(&mCommitsMutex);
 
-   if (!sha.isEmpty())
+   const auto ancestorRow = rowOf(ancestorSha);
+   const auto row = rowOf(sha);
+
+   if (ancestorRow == -1 || row == -1)
+      return std::nullopt;
+
+   return isAncestorRow(ancestorRow, row);
+}
+
+void GitCache::updateLocalBranchDistances(const QHash<QString, QString> &upstreams)
+{
+   static const QString remotesPrefix("refs/remotes/");
+   static const QString headsPrefix("refs/heads/");
+
+   QHash<QString, TrackedBranch> branches;
+
+   {
+      QMutexLocker lock(&mReferencesMutex);
+
+      const auto localShas = mReferenceShas.value(References::Type::LocalBranch);
+      const auto remoteShas = mReferenceShas.value(References::Type::RemoteBranches);
+
+      for (auto iter = upstreams.cbegin(); iter != upstreams.cend(); ++iter)
+      {
+         TrackedBranch branch;
+         branch.sha = localShas.value(iter.key());
+
+         if (iter.value().startsWith(remotesPrefix))
+            branch.upstreamSha = remoteShas.value(iter.value().mid(remotesPrefix.length()));
+         else if (iter.value().startsWith(headsPrefix))
+            branch.upstreamSha = localShas.value(iter.value().mid(headsPrefix.length()));
+
+         if (branch.sha.isEmpty() || branch.upstreamSha.isEmpty())
+            continue;
+
+         // The distances of the branches whose tips didn't move are still valid.
+         if (const auto known = mLocalBranchDistances.constFind(iter.key());
+             known != mLocalBranchDistances.cend() && known->sha == branch.sha
+             && known->upstreamSha == branch.upstreamSha)
+         {
+            branch.distances = known->distances;
+         }
+
+         branches.insert(iter.key(), branch);
+      }
+   }
+
+   auto calculated = 0;
+
    {
-      const auto c = mCommitsMap.value(sha, CommitInfo());
+      QMutexLocker lock(&mCommitsMutex);
 
-      if (!c.isValid())
+      for (auto &branch : branches)
       {
-         const auto shas = mCommitsMap.keys();
-         const auto it = std::find_if(shas.cbegin(), shas.cend(),
-                                      [sha](const QString &shaToCompare) { return shaToCompare.startsWith(sha); });
+         if (branch.distances)
+            continue;
 
-         if (it != shas.cend())
-            return mCommitsMap.value(*it);
+         const auto row = rowOf(branch.sha);
+         const auto upstreamRow = rowOf(branch.upstreamSha);
 
-         return CommitInfo();
+         if (row != -1 && upstreamRow != -1)
+         {
+            branch.distances = calculateDistances(row, upstreamRow);
+            ++calculated;
+         }
       }
+   }
+
+   {
+      QMutexLocker lock(&mReferencesMutex);
+
+      mLocalBranchDistances.clear();
 
-      return c;
+      for (auto iter = branches.cbegin(); iter != branches.cend(); ++iter)
+      {
+         if (iter->distances)
+            mLocalBranchDistances.insert(iter.key(), iter.value());
+      }
    }
 
-   return CommitInfo();
+   QLog_Debug("Cache",
+              QString("Calculated the distances of {%1} of {%2} tracking branches.")
+                  .arg(calculated)
+                  .arg(branches.count()));
+
+   emit signalLocalBranchDistancesUpdated();
+}
+
+std::optional<GitCache::LocalBranchDistances> GitCache::getLocalBranchDistances(const QString &branch) const
+{
+   QMutexLocker lock(&mReferencesMutex);
+
+   if (const auto iter = mLocalBranchDistances.constFind(branch); iter != mLocalBranchDistances.cend())
+      return iter->distances;
+
+   return std::nullopt;
+}
+
+CommitInfo GitCache::commitInfo(const QString &sha)
+{
+   CommitInfo commit;
+
+   if (findCommit(sha, commit) == ShaIndex::MatchType::Ambiguous)
+      QLog_Warning("Cache", QString("The SHA {%1} is ambiguous.").arg(sha));
+
+   return commit;
+}
+
+int GitCache::findRow(const QString &sha) const
+{
+   if (sha.isEmpty())
+      return -1;
+
+   if (const auto row = rowOf(sha); row != -1)
+      return row;
+
+   const auto match = mShaIndex.find(sha);
+
+   return match.type == ShaIndex::MatchType::Unique ? rowOf(match.sha) : -1;
+}
+
+ShaIndex::MatchType GitCache::findCommit(const QString &sha, CommitInfo &commit)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   if (sha.isEmpty())
+      return ShaIndex::MatchType::None;
+
+   if (const auto row = rowOf(sha); row != -1)
+   {
+      commit = mCommits.at(row);
+      return ShaIndex::MatchType::Unique;
+   }
+
+   const auto match = mShaIndex.find(sha);
+
+   if (match.type == ShaIndex::MatchType::Unique)
+   {
+      if (const auto row = rowOf(match.sha); row != -1)
+         commit = mCommits.at(row);
+   }
+
+   return match.type;
 }
 
 std::optional<RevisionFiles> GitCache::revisionFile(const QString &sha1, const QString &sha2) const
 {
    QMutexLocker lock(&mRevisionsMutex);
 
-   const auto iter = mRevisionFilesMap.constFind(qMakePair(sha1, sha2));
+   const auto key = qMakePair(sha1, sha2);
 
-   if (iter != mRevisionFilesMap.cend())
-      return *iter;
+   if (sha1 == CommitInfo::ZERO_SHA)
+   {
+      if (const auto iter = mWipRevisionFiles.constFind(key); iter != mWipRevisionFiles.cend())
+         return *iter;
+   }
+   else if (const auto files = mRevisionFilesMap.object(key))
+      return *files;
 
    return std::nullopt;
 }
 
-void GitCache::clearReferences()
+void GitCache::prefetchRevisionFiles(const QString &sha)
+{
+   if (!sha.isEmpty())
+      emit signalRevisionFilesPrefetchRequested(sha);
+}
+
+QVector<QPair<QString, QString>> GitCache::revisionFilesToPrefetch(const QString &sha) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+   QMutexLocker lock2(&mRevisionsMutex);
+
+   QVector<QPair<QString, QString>> revisions;
+   const auto row = rowOf(sha);
+
+   if (row == -1)
+      return revisions;
+
+   // The closest commits first: they are the ones the user is going to select next.
+   for (auto distance = 1; distance <= PREFETCH_NEIGHBOURS; ++distance)
+   {
+      for (const auto neighbour : { row + distance, row - distance })
+      {
+         if (neighbour <= 0 || neighbour >= mCommits.count())
+            continue;
+
+         if (mCommits.parentsCount(neighbour) == 0)
+            continue;
+
+         if (const auto key = qMakePair(mCommits.sha(neighbour), mCommits.parent(neighbour, 0).toSha());
+             !mRevisionFilesMap.contains(key))
+            revisions.append(key);
+      }
+   }
+
+   return revisions;
+}
+
+void GitCache::updateReferences(const QMap<References::Type, QHash<QString, QString>> &references,
+                                const QString &currentBranch, const QString &currentSha)
 {
    QMutexLocker lock(&mReferencesMutex);
-   mReferences.clear();
-   mReferences.squeeze();
+
+   auto added = 0;
+   auto removed = 0;
+
+   for (auto typeIter = references.cbegin(); typeIter != references.cend(); ++typeIter)
+   {
+      const auto changes = applyReferences(typeIter.key(), typeIter.value());
+      added += changes.first;
+      removed += changes.second;
+   }
+
+   QLog_Debug("Cache", QString("Updating the references: {%1} added and {%2} removed.").arg(added).arg(removed));
+
+   setCurrentBranch(currentBranch, currentSha);
+}
+
+QPair<int, int> GitCache::applyReferences(References::Type type, const QHash<QString, QString> &newShas)
+{
+   auto &currentShas = mReferenceShas[type];
+   auto added = 0;
+   auto removed = 0;
+
+   for (auto iter = currentShas.begin(); iter != currentShas.end();)
+   {
+      if (newShas.value(iter.key()) != iter.value())
+      {
+         removeReference(iter.value(), type, iter.key());
+         iter = currentShas.erase(iter);
+         ++removed;
+      }
+      else
+         ++iter;
+   }
+
+   for (auto iter = newShas.cbegin(); iter != newShas.cend(); ++iter)
+   {
+      if (!currentShas.contains(iter.key()))
+      {
+         mReferences[iter.value()].addReference(type, iter.key());
+         currentShas.insert(iter.key(), iter.value());
+         ++added;
+      }
+   }
+
+   return qMakePair(added, removed);
+}
+
+std::optional<QMap<QString, QString>> GitCache::getSubtrees() const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   // A subtree split before the oldest commit loaded would be missing.
+   if (!mInitialized || !mConfigured || mHistoryTruncated)
+      return std::nullopt;
+
+   return mSubtrees;
+}
+
+void GitCache::setHistoryTruncated(bool truncated)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   mHistoryTruncated = truncated;
+}
+
+bool GitCache::isHistoryTruncated() const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return mHistoryTruncated;
+}
+
+void GitCache::indexSubtree(const CommitInfo &commit, bool replace)
+{
+   static const QString dirTag("git-subtree-dir:");
+   static const QString splitTag("git-subtree-split:");
+
+   if (!commit.longLog.contains(dirTag))
+      return;
+
+   QString dir;
+   QString split;
+   const auto lines = commit.longLog.split('\n');
+
+   for (const auto &line : lines)
+   {
+      if (line.contains(dirTag))
+         dir = line.section(dirTag, 1).trimmed();
+      else if (line.contains(splitTag))
+         split = line.section(splitTag, 1).trimmed();
+   }
+
+   if (!dir.isEmpty() && (replace || !mSubtrees.contains(dir)))
+      mSubtrees.insert(dir, split);
+}
+
+void GitCache::addReference(const QString &sha, References::Type type, const QString &reference)
+{
+   mReferences[sha].addReference(type, reference);
+   mReferenceShas[type].insert(reference, sha);
+}
+
+void GitCache::removeReference(const QString &sha, References::Type type, const QString &reference)
+{
+   if (const auto iter = mReferences.find(sha); iter != mReferences.end())
+   {
+      iter->removeReference(type, reference);
+
+      if (iter->isEmpty())
+         mReferences.erase(iter);
+   }
 }
 
 void GitCache::insertWipRevision(const QString parentSha, const RevisionFiles &files)
@@ -198,18 +817,36 @@ void GitCache::insertWipRevision(const QString parentSha, const RevisionFiles &f
    if (!newParentSha.isEmpty())
       parents.append(newParentSha);
 
-   if (mLanes.isEmpty())
-      mLanes.init(CommitInfo::ZERO_SHA);
-
    const auto log = files.count() == mUntrackedFiles.count() ? tr("No local changes") : tr("Local changes");
-   CommitInfo c(CommitInfo::ZERO_SHA, parents, std::chrono::seconds(QDateTime::currentSecsSinceEpoch()), log);
-   calculateLanes(c);
+   const auto firstWip = !mCommits.hasWip();
+   const auto previousParentSha = firstWip ? QString() : mCommits.constFirst().firstParent();
 
-   if (mCommits[0])
-      c.setLanes(mCommits[0]->lanes());
+   mCommits.setWip(
+       CommitInfo(CommitInfo::ZERO_SHA, parents, std::chrono::seconds(QDateTime::currentSecsSinceEpoch()), log));
+   mCommits.linkWip(rowOf(newParentSha));
+
+   // The WIP starts the graph: the state of the lanes only moves past it when the history is being set up.
+   if (firstWip)
+   {
+      mLanes.init(Lanes::shaId(CommitInfo::ZERO_SHA));
+      mLanesCheckpoints.append(qMakePair(0, mLanes));
 
-   mCommitsMap.insert(CommitInfo::ZERO_SHA, std::move(c));
-   mCommits[0] = &mCommitsMap[CommitInfo::ZERO_SHA];
+      calculateLanes(mLanes, mCommits, 0);
+   }
+   // The lanes below the WIP lead to its parent. When it changes, the checkpoints are calculated again until they match
+   // the old ones. The new version of the lanes makes the readers drop the rows they calculated.
+   else if (previousParentSha != newParentSha)
+      recalculateLanes(0);
+
+   invalidateLanes();
+
+   mShaIndex.insert(CommitInfo::ZERO_SHA);
+   updateGenerations(0, 0);
+   publishCommits();
+
+   const auto pendingLocalChanges = files.count() - mUntrackedFiles.count() > 0;
+
+   updateRenderState([pendingLocalChanges](RenderState &state) { state.pendingLocalChanges = pendingLocalChanges; });
 }
 
 bool GitCache::insertRevisionFiles(const QString &sha1, const QString &sha2, const RevisionFiles &file)
@@ -225,16 +862,26 @@ bool GitCache::insertRevisionFile(const QString &sha1, const QString &sha2, cons
    const auto emptyShas = !sha1.isEmpty() && !sha2.isEmpty();
    const auto isWip = sha1 == CommitInfo::ZERO_SHA;
 
-   if ((emptyShas || isWip) && mRevisionFilesMap.value(key) != file)
+   if (isWip)
    {
-      QLog_Debug("Cache", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+      if (mWipRevisionFiles.value(key) == file)
+         return false;
 
-      mRevisionFilesMap.insert(key, file);
+      mWipRevisionFiles.insert(key, file);
+   }
+   else if (emptyShas)
+   {
+      if (const auto files = mRevisionFilesMap.object(key); files && *files == file)
+         return false;
 
-      return true;
+      mRevisionFilesMap.insert(key, new RevisionFiles(file), file.memoryCost());
    }
+   else
+      return false;
 
-   return false;
+   QLog_Debug("Cache", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+
+   return true;
 }
 
 void GitCache::insertReference(const QString &sha, References::Type type, const QString &reference)
@@ -243,67 +890,70 @@ void GitCache::insertReference(const QString &sha, References::Type type, const
 
    QLog_Trace("Cache", QString("Adding a new reference with SHA {%1}.").arg(sha));
 
-   mReferences[sha].addReference(type, reference);
+   addReference(sha, type, reference);
+   publishReferences();
 }
 
 void GitCache::deleteReference(const QString &sha, References::Type type, const QString &reference)
 {
    QMutexLocker lock(&mReferencesMutex);
 
-   mReferences[sha].removeReference(type, reference);
+   removeReference(sha, type, reference);
+
+   if (auto &shas = mReferenceShas[type]; shas.value(reference) == sha)
+      shas.remove(reference);
+
+   publishReferences();
 }
 
-bool GitCache::hasReferences(const QString &sha)
+void GitCache::moveReference(const QString &oldSha, const QString &newSha, References::Type type,
+                             const QString &reference)
 {
    QMutexLocker lock(&mReferencesMutex);
 
-   return mReferences.contains(sha) && !mReferences.value(sha).isEmpty();
+   removeReference(oldSha, type, reference);
+   addReference(newSha, type, reference);
+   publishReferences();
 }
 
-QStringList GitCache::getReferences(const QString &sha, References::Type type)
+bool GitCache::hasReferences(const QString &sha)
 {
-   QMutexLocker lock(&mReferencesMutex);
+   const auto state = renderState();
+   const auto iter = state->references.constFind(sha);
 
-   return mReferences.value(sha).getReferences(type);
+   return iter != state->references.cend() && !iter->isEmpty();
+}
+
+QStringList GitCache::getReferences(const QString &sha, References::Type type)
+{
+   return renderState()->references.value(sha).getReferences(type);
 }
 
 QString GitCache::getShaOfReference(const QString &referenceName, References::Type type) const
 {
    QMutexLocker lock(&mReferencesMutex);
 
-   for (auto iter = mReferences.cbegin(); iter != mReferences.cend(); ++iter)
-   {
-      const auto references = iter.value().getReferences(type);
-
-      for (const auto &reference : references)
-         if (reference == referenceName)
-            return iter.key();
-   }
+   if (const auto iter = mReferenceShas.constFind(type); iter != mReferenceShas.cend())
+      return iter->value(referenceName);
 
    return QString();
 }
 
-void GitCache::reloadCurrentBranchInfo(const QString &currentBranch, const QString &currentSha)
+void GitCache::setCurrentBranch(const QString &currentBranch, const QString &currentSha)
 {
-   QMutexLocker lock(&mReferencesMutex);
+   auto &branchShas = mReferenceShas[References::Type::LocalBranch];
 
-   const auto lastItem = mReferences.end();
-   for (auto ref = mReferences.begin(); ref != lastItem; ++ref)
-   {
-      if (ref.value().getReferences(References::Type::LocalBranch).contains(currentBranch))
-      {
-         ref.value().removeReference(References::Type::LocalBranch, currentBranch);
+   if (const auto iter = branchShas.constFind(currentBranch); iter != branchShas.cend())
+      removeReference(iter.value(), References::Type::LocalBranch, currentBranch);
 
-         const auto key = ref.key();
+   addReference(currentSha, References::Type::LocalBranch, currentBranch);
 
-         if (mReferences.value(key).isEmpty())
-            mReferences.remove(key);
-
-         break;
-      }
-   }
-
-   mReferences[currentSha].addReference(References::Type::LocalBranch, currentBranch);
+   updateRenderState([this, &currentBranch, &currentSha](RenderState &state) {
+      state.references = mReferences;
+      state.currentBranch = currentBranch;
+      state.headSha = currentSha;
+      state.detached = currentBranch.isEmpty() || currentBranch == QString("HEAD");
+   });
 }
 
 bool GitCache::updateWipCommit(const QString &parentSha, const RevisionFiles &files)
@@ -324,23 +974,30 @@ void GitCache::insertCommit(CommitInfo commit)
 {
    QMutexLocker lock2(&mCommitsMutex);
 
-   const auto sha = commit.sha;
-   const auto parentSha = commit.firstParent();
+   shiftRows(1);
 
-   commit.setLanes({ LaneType::ACTIVE });
-   commit.pos = 1;
+   mapRow(ObjectId::fromSha(commit.sha), 1);
+   mShaIndex.insert(commit.sha);
+   updateSearchIndex(true, commit);
+   indexSubtree(commit, true);
+   mCommits.prepend({ commit });
 
-   mCommitsMap[sha] = std::move(commit);
-   mCommitsMap[sha].appendChild(&mCommitsMap[CommitInfo::ZERO_SHA]);
+   if (!mGenerations.isEmpty())
+      mGenerations.insert(1, 0U);
 
-   mCommitsMap[parentSha].removeChild(&mCommitsMap[CommitInfo::ZERO_SHA]);
-   mCommitsMap[parentSha].appendChild(&mCommitsMap[sha]);
+   for (auto i = 0; i < mCommits.parentLinksCount(1); ++i)
+   {
+      const auto parent = mCommits.parent(1, i);
 
-   const auto total = mCommits.count();
-   for (auto i = 1; i < total; ++i)
-      ++mCommits[i]->pos;
+      if (const auto parentRow = rowOf(parent); parentRow != -1)
+         mCommits.linkParent(1, parent, parentRow);
+   }
+
+   // The new commit is the one checked out.
+   mCommits.linkWip(1);
 
-   mCommits.insert(1, &mCommitsMap[sha]);
+   updateGenerations(0, 1);
+   publishCommits();
 }
 
 void GitCache::updateCommit(const QString &oldSha, CommitInfo newCommit)
@@ -348,76 +1005,242 @@ void GitCache::updateCommit(const QString &oldSha, CommitInfo newCommit)
    QMutexLocker lock(&mCommitsMutex);
    QMutexLocker lock2(&mRevisionsMutex);
 
-   auto &oldCommit = mCommitsMap[oldSha];
-   const auto oldCommitParens = oldCommit.parents();
+   const auto row = rowOf(oldSha);
+
+   if (row <= 0)
+      return;
+
    const auto newCommitSha = newCommit.sha;
 
-   mCommitsMap.remove(oldSha);
-   mCommitsMap.insert(newCommitSha, std::move(newCommit));
-   mCommits[newCommit.pos] = &mCommitsMap[newCommitSha];
+   invalidateLanes();
 
-   for (const auto &parent : oldCommitParens)
+   mCommitsMap.remove(ObjectId::fromSha(oldSha));
+   mapRow(ObjectId::fromSha(newCommitSha), row);
+   mShaIndex.remove(oldSha);
+   mShaIndex.insert(newCommitSha);
+   updateSearchIndex(false, mCommits.at(row));
+   updateSearchIndex(true, newCommit);
+   indexSubtree(newCommit, true);
+
+   mCommits.unlinkParents(row);
+   mCommits.replace(row, newCommit);
+
+   for (auto i = 0; i < mCommits.parentLinksCount(row); ++i)
    {
-      mCommitsMap[parent].removeChild(&oldCommit);
-      mCommitsMap[parent].appendChild(&mCommitsMap[newCommitSha]);
+      const auto parent = mCommits.parent(row, i);
+
+      if (const auto parentRow = rowOf(parent); parentRow != -1)
+         mCommits.linkParent(row, parent, parentRow);
    }
 
-   const auto tags = getReferences(oldSha, References::Type::LocalTag);
-   for (const auto &tag : tags)
    {
-      insertReference(newCommitSha, References::Type::LocalTag, tag);
-      deleteReference(oldSha, References::Type::LocalTag, tag);
+      QMutexLocker referencesLock(&mReferencesMutex);
+
+      const auto references = mReferences.value(oldSha);
+
+      for (const auto type : { References::Type::LocalTag, References::Type::LocalBranch })
+      {
+         for (const auto &reference : references.getReferences(type))
+         {
+            removeReference(oldSha, type, reference);
+            addReference(newCommitSha, type, reference);
+         }
+      }
+
+      publishReferences();
    }
 
-   const auto localBranches = getReferences(oldSha, References::Type::LocalBranch);
-   for (const auto &branch : localBranches)
+   // The commits above it are its descendants: their generations depend on the new parents.
+   updateGenerations(0, row);
+   publishCommits();
+}
+
+void GitCache::buildSearchIndex()
+{
+   CommitPages commits;
+
    {
-      insertReference(newCommitSha, References::Type::LocalBranch, branch);
-      deleteReference(oldSha, References::Type::LocalBranch, branch);
+      QMutexLocker lock(&mCommitsMutex);
+      QMutexLocker indexLock(&mSearchIndexMutex);
+
+      // The commits inserted or updated while the index is built are stored and applied once it's done.
+      commits = mCommits;
+      mSearchIndexBuilding = true;
+      mPendingSearchIndexUpdates.clear();
+   }
+
+   QLog_Debug("Cache", QString("Building the search index for {%1} commits.").arg(commits.count()));
+
+   CommitSearchIndex index;
+   index.reserve(commits.count());
+
+   // The WIP is not indexed.
+   for (auto row = commits.hasWip() ? 1 : 0; row < commits.count(); ++row)
+      index.insert(commits.at(row));
+
+   commits.clear();
+
+   {
+      QMutexLocker indexLock(&mSearchIndexMutex);
+
+      for (const auto &update : qAsConst(mPendingSearchIndexUpdates))
+      {
+         if (update.first)
+            index.insert(update.second);
+         else
+            index.remove(update.second.sha);
+      }
+
+      mSearchIndex = std::move(index);
+      mSearchIndexReady = true;
+      mSearchIndexBuilding = false;
+      mPendingSearchIndexUpdates.clear();
+   }
+
+   QLog_Debug("Cache", "Search index built.");
+
+   emit searchIndexReady();
+}
+
+void GitCache::resetSearchIndex()
+{
+   QMutexLocker lock(&mSearchIndexMutex);
+
+   mSearchIndex.clear();
+   mSearchIndexReady = false;
+   mSearchIndexBuilding = false;
+   mPendingSearchIndexUpdates.clear();
+}
+
+void GitCache::updateSearchIndex(bool insert, const CommitInfo &commit)
+{
+   QMutexLocker lock(&mSearchIndexMutex);
+
+   if (mSearchIndexBuilding)
+      mPendingSearchIndexUpdates.append(qMakePair(insert, commit));
+   else if (mSearchIndexReady)
+   {
+      if (insert)
+         mSearchIndex.insert(commit);
+      else
+         mSearchIndex.remove(commit.sha);
    }
 }
 
-void GitCache::calculateLanes(CommitInfo &c)
+ChangedPathsIndex GitCache::updateChangedPaths(const ChangedPathsIndex &index, bool replace)
 {
-   const auto sha = c.sha;
+   ChangedPathsIndex updated;
+
+   {
+      QMutexLocker lock(&mChangedPathsMutex);
+
+      if (replace)
+         mChangedPaths = index;
+      else
+         mChangedPaths.merge(index);
 
-   QLog_Trace("Cache", QString("Updating the lanes for SHA {%1}.").arg(sha));
+      mChangedPathsReady = true;
+      updated = mChangedPaths;
+   }
+
+   emit changedPathsReady();
+
+   return updated;
+}
+
+void GitCache::calculateLanes(Lanes &lanes, const CommitPages &commits, int row, QVector<Lane> *laneRow)
+{
+   const auto sha = commits.oid(row).prefix();
+   const auto parentsCount = commits.parentsCount(row);
 
    bool isDiscontinuity;
-   bool isFork = mLanes.isFork(sha, isDiscontinuity);
-   bool isMerge = c.parentsCount() > 1;
+   bool isFork = lanes.isFork(sha, isDiscontinuity);
+   bool isMerge = parentsCount > 1;
 
    if (isDiscontinuity)
-      mLanes.changeActiveLane(sha);
+      lanes.changeActiveLane(sha);
 
    if (isFork)
-      mLanes.setFork(sha);
+      lanes.setFork(sha);
    if (isMerge)
-      mLanes.setMerge(c.parents());
-   if (c.parentsCount() == 0)
-      mLanes.setInitial();
+   {
+      QVector<quint64> parents;
+      parents.reserve(commits.parentLinksCount(row));
 
-   const auto lanes = mLanes.getLanes();
+      for (auto i = 0; i < commits.parentLinksCount(row); ++i)
+         parents.append(commits.parent(row, i).prefix());
 
-   resetLanes(c, isFork);
+      lanes.setMerge(parents);
+   }
+   if (parentsCount == 0)
+      lanes.setInitial();
 
-   c.setLanes(std::move(lanes));
+   if (laneRow)
+      *laneRow = lanes.getLanes();
+
+   resetLanes(lanes, commits, row, isFork);
 }
 
-bool GitCache::pendingLocalChanges()
+QVector<Lane> GitCache::lanes(const RenderState &state, int row)
 {
-   QMutexLocker lock(&mCommitsMutex);
-   QMutexLocker lock2(&mRevisionsMutex);
+   const auto &checkpoints = state.lanesCheckpoints;
 
-   auto localChanges = false;
+   if (row < 0 || row >= state.commits.count())
+      return {};
 
-   if (const auto commit = mCommitsMap.value(CommitInfo::ZERO_SHA, CommitInfo()); commit.isValid())
+   // The lanes kept were calculated for a version of the history that changed the graph.
+   if (mLanesCacheVersion != state.lanesVersion)
    {
-      if (const auto rf = revisionFile(CommitInfo::ZERO_SHA, commit.firstParent()); rf)
-         localChanges = rf.value().count() - mUntrackedFiles.count() > 0;
+      mLanesCache.clear();
+      mLanesCursor.clear();
+      mLanesCursorRow = -1;
+      mLanesCacheVersion = state.lanesVersion;
    }
 
-   return localChanges;
+   if (const auto lanes = mLanesCache.object(row))
+      return *lanes;
+
+   auto checkpoint = std::upper_bound(
+       checkpoints.cbegin(), checkpoints.cend(), row,
+       [](int value, const QPair<int, Lanes> &checkpoint) { return value < checkpoint.first; });
+
+   if (checkpoint == checkpoints.cbegin())
+      return {};
+
+   --checkpoint;
+
+   // The rows are painted from top to bottom, so the state after the last row calculated is used when it's closer than
+   // the checkpoint.
+   const auto useCursor = mLanesCursorRow != -1 && mLanesCursorRow <= row && mLanesCursorRow >= checkpoint->first;
+   auto lanes = useCursor ? mLanesCursor : checkpoint->second;
+   QVector<Lane> laneRow;
+
+   for (auto i = useCursor ? mLanesCursorRow : checkpoint->first; i <= row; ++i)
+   {
+      calculateLanes(lanes, state.commits, i, &laneRow);
+      mLanesCache.insert(i, new QVector<Lane>(laneRow));
+   }
+
+   mLanesCursor = lanes;
+   mLanesCursorRow = row + 1;
+
+   return laneRow;
+}
+
+void GitCache::invalidateLanes()
+{
+   // The readers drop the lanes they calculated when the new version is published.
+   ++mLanesVersion;
+}
+
+bool GitCache::pendingLocalChanges() const
+{
+   return renderState()->pendingLocalChanges;
+}
+
+std::shared_ptr<const GitCache::RenderState> GitCache::renderState() const
+{
+   return std::atomic_load(&mRenderState);
 }
 
 QVector<QPair<QString, QStringList>> GitCache::getBranches(References::Type type)
@@ -437,48 +1260,167 @@ QMap<QString, QString> GitCache::getTags(References::Type tagType) const
 
    QMap<QString, QString> tags;
 
-   for (auto iter = mReferences.cbegin(); iter != mReferences.cend(); ++iter)
+   if (const auto shas = mReferenceShas.constFind(tagType); shas != mReferenceShas.cend())
    {
-      const auto tagNames = iter->getReferences(tagType);
-
-      for (const auto &tag : tagNames)
-         tags[tag] = iter.key();
+      for (auto iter = shas->cbegin(); iter != shas->cend(); ++iter)
+         tags.insert(iter.key(), iter.value());
    }
 
    return tags;
 }
 
-void GitCache::updateTags(QMap<QString, QString> remoteTags)
+void GitCache::updateTags(const QHash<QString, QString> &remoteTags)
 {
-   const auto end = remoteTags.cend();
+   {
+      QMutexLocker lock(&mReferencesMutex);
+
+      // The tags deleted in the remote are removed too.
+      const auto changes = applyReferences(References::Type::RemoteTag, remoteTags);
 
-   for (auto iter = remoteTags.cbegin(); iter != end; ++iter)
-      insertReference(iter.value(), References::Type::RemoteTag, iter.key());
+      QLog_Debug("Cache", QString("Updating the remote tags: {%1} added and {%2} removed.")
+                             .arg(changes.first)
+                             .arg(changes.second));
+
+      publishReferences();
+   }
 
    emit signalCacheUpdated();
 }
 
-void GitCache::resetLanes(const CommitInfo &c, bool isFork)
+void GitCache::resetLanes(Lanes &lanes, const CommitPages &commits, int row, bool isFork)
 {
-   const auto nextSha = c.parentsCount() == 0 ? QString() : c.firstParent();
+   const auto parentsCount = commits.parentsCount(row);
 
-   mLanes.nextParent(nextSha);
+   lanes.nextParent(parentsCount == 0 ? Lanes::NO_SHA : commits.parent(row, 0).prefix());
 
-   if (c.parentsCount() > 1)
-      mLanes.afterMerge();
+   if (parentsCount > 1)
+      lanes.afterMerge();
    if (isFork)
-      mLanes.afterFork();
-   if (mLanes.isBranch())
-      mLanes.afterBranch();
+      lanes.afterFork();
+   if (lanes.isBranch())
+      lanes.afterBranch();
 }
 
-bool GitCache::checkSha(const QString &originalSha, const QString &currentSha) const
+GitCache::LocalBranchDistances GitCache::calculateDistances(int row, int upstreamRow) const
 {
-   if (originalSha == currentSha)
+   enum Side : quint8
+   {
+      Local = 1,
+      Upstream = 2,
+      Both = Local | Upstream
+   };
+
+   LocalBranchDistances distances;
+   QHash<int, quint8> sides { { row, Local } };
+   sides[upstreamRow] |= Upstream;
+
+   std::priority_queue<QPair<uint, int>> pending;
+   pending.push(qMakePair(generation(row), row));
+
+   if (upstreamRow != row)
+      pending.push(qMakePair(generation(upstreamRow), upstreamRow));
+
+   // The commits are visited from the highest generation down, so the side of a commit is final when it's visited.
+   // The walk stops as soon as only commits reachable from both tips are pending.
+   auto oneSided = upstreamRow != row ? 2 : 0;
+
+   while (oneSided > 0 && !pending.empty())
+   {
+      const auto current = pending.top().second;
+      pending.pop();
+
+      const auto side = sides.value(current);
+
+      if (side == Local)
+      {
+         ++distances.aheadOrigin;
+         --oneSided;
+      }
+      else if (side == Upstream)
+      {
+         ++distances.behindOrigin;
+         --oneSided;
+      }
+
+      for (auto i = 0; i < mCommits.parentLinksCount(current); ++i)
+      {
+         const auto parentRow = mCommits.parentRow(current, i);
+
+         if (parentRow == -1)
+            continue;
+
+         if (const auto iter = sides.find(parentRow); iter == sides.end())
+         {
+            sides.insert(parentRow, side);
+            pending.push(qMakePair(generation(parentRow), parentRow));
+
+            if (side != Both)
+               ++oneSided;
+         }
+         else if ((iter.value() | side) != iter.value())
+         {
+            iter.value() |= side;
+            --oneSided;
+         }
+      }
+   }
+
+   return distances;
+}
+
+void GitCache::updateGenerations(int firstRow, int lastRow)
+{
+   // The parents are always below their children, so going up the rows they are calculated before them. The parents
+   // that are not loaded (the boundary of a partial history) count as generation zero.
+   mGenerations.resize(mCommits.count());
+
+   for (auto row = lastRow; row >= firstRow; --row)
+   {
+      auto highest = 0U;
+
+      for (auto i = 0; i < mCommits.parentLinksCount(row); ++i)
+      {
+         if (const auto parentRow = mCommits.parentRow(row, i); parentRow != -1)
+            highest = std::max(highest, mGenerations.at(parentRow));
+      }
+
+      mGenerations[row] = highest + 1;
+   }
+}
+
+bool GitCache::isAncestorRow(int ancestorRow, int row) const
+{
+   if (ancestorRow == row)
       return true;
 
-   if (const auto iter = mCommitsMap.find(currentSha); iter != mCommitsMap.cend())
-      return checkSha(originalSha, iter->firstParent());
+   // Every ancestor has a lower generation than its descendants: the commits with a generation not higher than the
+   // one searched can't lead to it. Commits without a generation yet are never discarded.
+   const auto minGeneration = generation(ancestorRow);
+   QVector<int> pending { row };
+   QSet<int> visited;
+
+   while (!pending.isEmpty())
+   {
+      const auto current = pending.takeLast();
+
+      for (auto i = 0; i < mCommits.parentLinksCount(current); ++i)
+      {
+         const auto parentRow = mCommits.parentRow(current, i);
+
+         if (parentRow == ancestorRow)
+            return true;
+
+         if (parentRow == -1 || visited.contains(parentRow))
+            continue;
+
+         if (const auto parentGeneration = generation(parentRow);
+             parentGeneration != 0 && parentGeneration <= minGeneration)
+            continue;
+
+         visited.insert(parentRow);
+         pending.append(parentRow);
+      }
+   }
 
    return false;
 }
@@ -486,22 +1428,56 @@ bool GitCache::checkSha(const QString &originalSha, const QString &currentSha) c
 void GitCache::clearInternalData()
 {
    mCommits.clear();
-   mCommits.squeeze();
    mCommitsMap.clear();
    mCommitsMap.squeeze();
+   mRowShift = 0;
+   mGenerations.clear();
+   mGenerations.squeeze();
+   mShaIndex.clear();
+   mTmpChildsStorage.clear();
+   mSubtrees.clear();
+   resetSearchIndex();
+   mChangedPaths.clear();
+   mChangedPathsReady = false;
    mReferences.clear();
    mRevisionFilesMap.clear();
-   mRevisionFilesMap.squeeze();
+   mWipRevisionFiles.clear();
+   mWipRevisionFiles.squeeze();
    mUntrackedFiles.clear();
    mUntrackedFiles.squeeze();
    mLanes.clear();
+   mLanesCheckpoints.clear();
+   invalidateLanes();
    mReferences.clear();
    mReferences.squeeze();
+   mReferenceShas.clear();
+   mLocalBranchDistances.clear();
+
+   publishCommits();
+   publishReferences();
 }
 
 int GitCache::commitCount() const
 {
-   return mCommits.count();
+   return renderState()->commits.count();
+}
+
+int GitCache::rowOf(const QString &sha) const
+{
+   auto valid = false;
+   const auto oid = ObjectId::fromSha(sha, &valid);
+
+   return valid ? rowOf(oid) : -1;
+}
+
+int GitCache::rowOf(const ObjectId &oid) const
+{
+   if (oid.isNull())
+      return mCommits.hasWip() ? 0 : -1;
+
+   const auto iter = mCommitsMap.constFind(oid);
+
+   return iter != mCommitsMap.cend() ? iter.value() + mRowShift : -1;
 }
 
 void GitCache::setUntrackedFilesList(QVector<QString> untrackedFiles)
@@ -23,15 +23,23 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ChangedPathsIndex.h>
 #include <CommitInfo.h>
+#include <CommitPages.h>
+#include <CommitSearchIndex.h>
+#include <ObjectId.h>
 #include <RevisionFiles.h>
+#include <ShaIndex.h>
 #include <lanes.h>
 
+#include <QCache>
 #include <QHash>
 #include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QSharedPointer>
 
+#include <memory>
 #include <optional>
 
 struct WipRevisionInfo;
@@ -43,6 +51,28 @@ class GitCache : public QObject
 signals:
    void signalCacheUpdated();
 
+   /**
+    * @brief Signal triggered when the search index has been built and @ref searchCommits can be used.
+    */
+   void searchIndexReady();
+
+   /**
+    * @brief Signal triggered when the index of the paths changed by the commits has been built or updated and
+    * @ref pathHistory can be used.
+    */
+   void changedPathsReady();
+
+   /**
+    * @brief Signal triggered when the ahead and behind distances of the local branches have been calculated.
+    */
+   void signalLocalBranchDistancesUpdated();
+
+   /**
+    * @brief Signal triggered when the files of the commits around a commit should be loaded before they are needed.
+    * @param sha The SHA of the commit selected.
+    */
+   void signalRevisionFilesPrefetchRequested(const QString &sha);
+
 public:
    struct LocalBranchDistances
    {
@@ -50,15 +80,133 @@ public:
       int behindOrigin = 0;
    };
 
+   /**
+    * @brief The RenderState struct contains the state of the repository needed to paint the history. It's replaced as
+    * a whole every time the commits or the references change so the UI can read it without locks nor Git calls. The
+    * copies share their data with the cache until it's modified, so publishing a new version is cheap.
+    */
+   struct RenderState
+   {
+      QString headSha;
+      QString currentBranch;
+      bool detached = false;
+      bool pendingLocalChanges = false;
+      CommitPages commits;
+      QHash<QString, References> references;
+      QVector<QPair<int, Lanes>> lanesCheckpoints;
+      int lanesVersion = 0;
+      int rowShift = 0;
+   };
+
    explicit GitCache(QObject *parent = nullptr);
    ~GitCache();
 
    int commitCount() const;
 
    CommitInfo commitInfo(const QString &sha);
-   CommitInfo commitInfo(int row);
+
+   /**
+    * @brief Returns the SHA of the commit in @p row of the last version of the history, without building the commit.
+    * @return The SHA, or an empty string if the row doesn't exist.
+    */
+   QString commitSha(int row) const;
+
+   /**
+    * @brief Returns the row of the commit with the given SHA, that can be abbreviated.
+    * @return The row, or -1 if the commit is not loaded or the abbreviation is ambiguous.
+    */
+   int commitRow(const QString &sha) const;
+
+   /**
+    * @brief Returns the subject of the commit with the given SHA, that can be abbreviated, without building the
+    * commit.
+    * @return The subject, or an empty string if the commit is not found.
+    */
+   QString commitShortLog(const QString &sha) const;
+
+   /**
+    * @brief Returns the lanes of the graph in the given row. The lanes are not stored with the commits: they are
+    * calculated on demand from the closest state of the lanes saved while loading and kept for the last rows used.
+    * They are calculated from a render state, so it must only be called from the UI thread.
+    * @param state The version of the history the row belongs to.
+    * @param row The row of the commit.
+    * @return The lanes of the row, or an empty list if the row doesn't exist.
+    */
+   QVector<Lane> lanes(const RenderState &state, int row);
+
+   /**
+    * @brief Looks for the commit with the given SHA, that can be abbreviated.
+    * @param sha The full or abbreviated SHA.
+    * @param commit The commit found. It's only set if the match is unique.
+    * @return The type of match. Abbreviations shared by several commits are reported as ambiguous.
+    */
+   ShaIndex::MatchType findCommit(const QString &sha, CommitInfo &commit);
    CommitInfo searchCommitInfo(const QString &text, int startingPoint = 0, bool reverse = false);
+
+   /**
+    * @brief Finds all the commits whose SHA starts with @p text or that contain words starting with the words of
+    * @p text in the subject, author or committer.
+    * @param text The text to search.
+    * @return The SHAs of the commits found, best matches first. If the search index is not built yet, std::nullopt.
+    */
+   std::optional<QStringList> searchCommits(const QString &text) const;
+
+   /**
+    * @brief Returns the rows of the commits with the given SHAs, sorted from the top of the history. The SHAs that are
+    * not loaded are skipped.
+    * @param rowShift The row shift of the version of the history the rows belong to (see RenderState::rowShift). The
+    * commits inserted after that version are skipped.
+    */
+   QVector<int> commitRows(const QStringList &shas, int rowShift) const;
+
+   /**
+    * @brief Finds the loaded commits that changed the file or any file under the directory @p path. The history of a
+    * file continues through its renames, with the older path, like git log --follow does.
+    * @param path The path relative to the root of the repository.
+    * @return The SHAs of the commits, newest first. If the index of the changed paths is not built yet, std::nullopt.
+    */
+   std::optional<QStringList> pathHistory(const QString &path) const;
    bool isCommitInCurrentGeneologyTree(const QString &sha);
+
+   /**
+    * @brief Checks if the commit @p ancestorSha is reachable from the commit @p sha through any of its parents.
+    * @param ancestorSha The SHA of the possible ancestor.
+    * @param sha The SHA of the descendant.
+    * @return True if @p ancestorSha is @p sha or one of its ancestors. If any of the commits is not loaded,
+    * std::nullopt.
+    */
+   std::optional<bool> isAncestor(const QString &ancestorSha, const QString &sha);
+
+   /**
+    * @brief Calculates how many commits every local branch is ahead and behind its upstream using the loaded history.
+    * Only the branches whose tip or upstream tip moved since the last call are calculated again.
+    * @param upstreams The full reference name of the upstream of each local branch that has one.
+    */
+   void updateLocalBranchDistances(const QHash<QString, QString> &upstreams);
+
+   /**
+    * @brief Returns the distances of the local branch @p branch to its upstream. If the branch doesn't have an
+    * upstream or they are not calculated yet, std::nullopt.
+    */
+   std::optional<LocalBranchDistances> getLocalBranchDistances(const QString &branch) const;
+
+   /**
+    * @brief Returns the subtrees of the repository, from their directory to the last commit split from them, as found
+    * in the messages of the commits loaded. They are indexed as the commits are added. If the history is not loaded
+    * yet or only its newest commits were loaded, std::nullopt.
+    */
+   std::optional<QMap<QString, QString>> getSubtrees() const;
+
+   /**
+    * @brief Sets if the history being loaded stops before the first commit because the number of commits is limited.
+    */
+   void setHistoryTruncated(bool truncated);
+
+   /**
+    * @brief Returns true if the history loaded stops before the first commit because the number of commits is limited.
+    */
+   bool isHistoryTruncated() const;
+
    bool updateWipCommit(const QString &parentSha, const RevisionFiles &files);
    void insertCommit(CommitInfo commit);
    void updateCommit(const QString &oldSha, CommitInfo newCommit);
@@ -66,22 +214,50 @@ public:
    bool insertRevisionFiles(const QString &sha1, const QString &sha2, const RevisionFiles &file);
    std::optional<RevisionFiles> revisionFile(const QString &sha1, const QString &sha2) const;
 
-   void clearReferences();
+   /**
+    * @brief Requests the files of the commits around @p sha to be loaded in the background, so they are already cached
+    * when the user moves to them. It doesn't lock the cache: the commits are looked up by the loader.
+    */
+   void prefetchRevisionFiles(const QString &sha);
+
+   /**
+    * @brief Returns the revisions around the commit @p sha whose files are not cached yet, the closest first.
+    */
+   QVector<QPair<QString, QString>> revisionFilesToPrefetch(const QString &sha) const;
+
+   /**
+    * @brief Replaces the references of the types in @p references with the ones given, from reference name to SHA.
+    * Only the references that were added, removed or moved are applied, all of them under the same lock and published
+    * once together with the current branch.
+    * @param references The references of every type, from reference name to SHA.
+    * @param currentBranch The branch checked out, or HEAD if it's detached.
+    * @param currentSha The SHA of the commit checked out.
+    */
+   void updateReferences(const QMap<References::Type, QHash<QString, QString>> &references,
+                         const QString &currentBranch, const QString &currentSha);
    void insertReference(const QString &sha, References::Type type, const QString &reference);
    void deleteReference(const QString &sha, References::Type type, const QString &reference);
+
+   /**
+    * @brief Moves the reference @p reference from the commit @p oldSha to @p newSha. The UI sees both changes at once.
+    */
+   void moveReference(const QString &oldSha, const QString &newSha, References::Type type, const QString &reference);
    bool hasReferences(const QString &sha);
    QStringList getReferences(const QString &sha, References::Type type);
    QString getShaOfReference(const QString &referenceName, References::Type type) const;
-   void reloadCurrentBranchInfo(const QString &currentBranch, const QString &currentSha);
 
    QVector<QString> getUntrackedFiles() const { return mUntrackedFiles; }
    void setUntrackedFilesList(QVector<QString> untrackedFiles);
-   bool pendingLocalChanges();
+   bool pendingLocalChanges() const;
+   std::shared_ptr<const RenderState> renderState() const;
 
    QVector<QPair<QString, QStringList>> getBranches(References::Type type);
    QMap<QString, QString> getTags(References::Type tagType) const;
 
-   void updateTags(QMap<QString, QString> remoteTags);
+   /**
+    * @brief Replaces the tags of the remote with @p remoteTags, from tag name to SHA.
+    */
+   void updateTags(const QHash<QString, QString> &remoteTags);
 
    bool isInitialized() const { return mInitialized; }
 
@@ -90,28 +266,102 @@ private:
 
    bool mInitialized = false;
    bool mConfigured = true;
+   bool mHistoryTruncated = false;
    Lanes mLanes;
    QVector<QString> mUntrackedFiles;
 
    mutable QMutex mCommitsMutex;
-   QVector<CommitInfo *> mCommits;
-   QHash<QString, CommitInfo> mCommitsMap;
+   CommitPages mCommits;
+   // The rows of the commits are stored minus the number of rows inserted on top of the history since they were
+   // added, so inserting rows doesn't change the values already stored. The WIP is not stored.
+   QHash<ObjectId, int> mCommitsMap;
+   int mRowShift = 0;
+   // One more than the highest generation of the parents of every row. Zero while it's not calculated yet.
+   QVector<uint> mGenerations;
+   ShaIndex mShaIndex;
+   QHash<ObjectId, QVector<int>> mTmpChildsStorage;
+   QMap<QString, QString> mSubtrees;
+   QVector<QPair<int, Lanes>> mLanesCheckpoints;
+   int mLanesVersion = 0;
+
+   // Only used by the UI thread when calculating the lanes of the render state.
+   QCache<int, QVector<Lane>> mLanesCache;
+   Lanes mLanesCursor;
+   int mLanesCursorRow = -1;
+   int mLanesCacheVersion = -1;
 
    mutable QMutex mRevisionsMutex;
-   QHash<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
+   // The files of the commits are evicted (least recently used first) once they use more than a memory budget. The
+   // ones of the WIP are always kept.
+   mutable QCache<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
+   QHash<QPair<QString, QString>, RevisionFiles> mWipRevisionFiles;
 
    mutable QMutex mReferencesMutex;
    QHash<QString, References> mReferences;
+   QMap<References::Type, QHash<QString, QString>> mReferenceShas;
+
+   struct TrackedBranch
+   {
+      QString sha;
+      QString upstreamSha;
+      std::optional<LocalBranchDistances> distances;
+   };
+   QHash<QString, TrackedBranch> mLocalBranchDistances;
+
+   mutable QMutex mSearchIndexMutex;
+   CommitSearchIndex mSearchIndex;
+   bool mSearchIndexReady = false;
+   bool mSearchIndexBuilding = false;
+   QVector<QPair<bool, CommitInfo>> mPendingSearchIndexUpdates;
+
+   mutable QMutex mChangedPathsMutex;
+   ChangedPathsIndex mChangedPaths;
+   bool mChangedPathsReady = false;
+
+   QMutex mRenderStateMutex;
+   std::shared_ptr<const RenderState> mRenderState;
 
    void setup(const QString &parentSha, const RevisionFiles &files, QVector<CommitInfo> commits);
+   void startSetup(const QString &parentSha, int expectedCommits = 0);
+   void appendCommits(QVector<CommitInfo> commits);
+   void finishSetup(const QString &parentSha, const RevisionFiles &files);
+   int insertCommits(QVector<CommitInfo> commits, const QString &wipParentSha, int &changedRows);
    void setConfigurationDone() { mConfigured = true; }
+   void buildSearchIndex();
+   void resetSearchIndex();
+   void updateSearchIndex(bool insert, const CommitInfo &commit);
+   ChangedPathsIndex updateChangedPaths(const ChangedPathsIndex &index, bool replace);
 
    bool insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file);
    void insertWipRevision(const QString parentSha, const RevisionFiles &files);
-   void calculateLanes(CommitInfo &c);
-   auto searchCommit(const QString &text, int startingPoint = 0) const;
-   auto reverseSearchCommit(const QString &text, int startingPoint = 0) const;
-   void resetLanes(const CommitInfo &c, bool isFork);
-   bool checkSha(const QString &originalSha, const QString &currentSha) const;
+   static void calculateLanes(Lanes &lanes, const CommitPages &commits, int row, QVector<Lane> *laneRow = nullptr);
+   int recalculateLanes(int insertedRows);
+   void invalidateLanes();
+   void shiftRows(int count);
+   int searchCommit(const QString &text, int startingPoint = 0) const;
+   int reverseSearchCommit(const QString &text, int startingPoint = 0) const;
+   static void resetLanes(Lanes &lanes, const CommitPages &commits, int row, bool isFork);
+   void addReference(const QString &sha, References::Type type, const QString &reference);
+   void removeReference(const QString &sha, References::Type type, const QString &reference);
+
+   /**
+    * @brief Replaces the references of @p type with @p newShas, applying only the ones that changed.
+    * @return The number of references added and removed.
+    */
+   QPair<int, int> applyReferences(References::Type type, const QHash<QString, QString> &newShas);
+   void setCurrentBranch(const QString &currentBranch, const QString &currentSha);
+   void indexSubtree(const CommitInfo &commit, bool replace);
+   void updateGenerations(int firstRow, int lastRow);
+   uint generation(int row) const { return row < mGenerations.count() ? mGenerations.at(row) : 0; }
+   bool isAncestorRow(int ancestorRow, int row) const;
+   LocalBranchDistances calculateDistances(int row, int upstreamRow) const;
+   int rowOf(const QString &sha) const;
+   int rowOf(const ObjectId &oid) const;
+   int findRow(const QString &sha) const;
+   void mapRow(const ObjectId &oid, int row) { mCommitsMap.insert(oid, row - mRowShift); }
+   template<typename Update>
+   void updateRenderState(Update update);
+   void publishCommits();
+   void publishReferences();
    void clearInternalData();
 };
@@ -0,0 +1,180 @@
+#include "HistorySnapshot.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+const quint32 HistorySnapshot::MAGIC = 0x47514853; // GQHS
+const quint32 HistorySnapshot::VERSION = 3;
+
+namespace
+{
+// A commit takes at least its SHA (40 UTF-16 characters and their size) and the size of every other field.
+const qint64 MIN_COMMIT_SIZE = 4 + 80 + 7 * 4 + 8 + 1;
+}
+
+HistorySnapshot::HistorySnapshot(const QString &filePath)
+   : mFilePath(filePath)
+{
+}
+
+bool HistorySnapshot::load(const QString &settingsKey)
+{
+   mTips.clear();
+   mCommits.clear();
+   mSegments = 0;
+
+   QFile file(mFilePath);
+
+   if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+      return false;
+
+   QDataStream in(&file);
+   in.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic = 0;
+   quint32 version = 0;
+   QString key;
+
+   in >> magic >> version;
+
+   if (magic != MAGIC || version != VERSION)
+   {
+      QLog_Info("Cache", QString("The history snapshot {%1} has an old format.").arg(mFilePath));
+      return false;
+   }
+
+   in >> key;
+
+   if (key != settingsKey)
+      return false;
+
+   QVector<QVector<CommitInfo>> segments;
+   auto total = 0;
+
+   while (!in.atEnd() && in.status() == QDataStream::Ok)
+   {
+      quint32 count = 0;
+      in >> mTips >> count;
+
+      // The count is only trusted as far as the rest of the file can hold that many commits.
+      if (in.status() != QDataStream::Ok || count > (file.size() - file.pos()) / MIN_COMMIT_SIZE)
+      {
+         in.setStatus(QDataStream::ReadCorruptData);
+         break;
+      }
+
+      QVector<CommitInfo> commits;
+      commits.reserve(static_cast<int>(count));
+
+      for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+      {
+         CommitInfo commit;
+         qint64 date = 0;
+
+         in >> commit.sha >> commit.mParentsSha >> commit.committer >> commit.author >> date >> commit.shortLog
+             >> commit.longLog >> commit.gpgKey >> commit.mGoodSignature;
+
+         commit.dateSinceEpoch = std::chrono::seconds(date);
+
+         commits.append(std::move(commit));
+      }
+
+      total += commits.count();
+      segments.append(std::move(commits));
+   }
+
+   if (in.status() != QDataStream::Ok || segments.isEmpty())
+   {
+      QLog_Warning("Cache", QString("The history snapshot {%1} is corrupted.").arg(mFilePath));
+
+      mTips.clear();
+
+      return false;
+   }
+
+   // Every segment has the commits added on top of the previous one, so the last segment has the newest commits.
+   mSegments = segments.count();
+   mCommits.reserve(total);
+
+   for (auto i = segments.count() - 1; i >= 0; --i)
+   {
+      for (auto &commit : segments[i])
+         mCommits.append(std::move(commit));
+   }
+
+   QLog_Info("Cache", QString("History snapshot loaded with {%1} commits.").arg(mCommits.count()));
+
+   return true;
+}
+
+bool HistorySnapshot::save(const QString &settingsKey, const QMap<QString, QString> &tips,
+                           const CommitPages &commits) const
+{
+   QSaveFile file(mFilePath);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Cache", QString("The history snapshot {%1} couldn't be written.").arg(mFilePath));
+      return false;
+   }
+
+   QDataStream out(&file);
+   out.setVersion(QDataStream::Qt_5_9);
+   out << MAGIC << VERSION << settingsKey;
+
+   writeSegment(out, tips, commits, commits.count() - (commits.hasWip() ? 1 : 0));
+
+   return file.commit();
+}
+
+bool HistorySnapshot::append(const QMap<QString, QString> &tips, const CommitPages &commits, int count) const
+{
+   QFile file(mFilePath);
+
+   if (!file.exists() || !file.open(QIODevice::WriteOnly | QIODevice::Append))
+   {
+      QLog_Warning("Cache", QString("The history snapshot {%1} couldn't be updated.").arg(mFilePath));
+      return false;
+   }
+
+   QDataStream out(&file);
+   out.setVersion(QDataStream::Qt_5_9);
+
+   writeSegment(out, tips, commits, count);
+
+   return out.status() == QDataStream::Ok && file.flush();
+}
+
+void HistorySnapshot::writeSegment(QDataStream &out, const QMap<QString, QString> &tips, const CommitPages &commits,
+                                   int count)
+{
+   out << tips << static_cast<quint32>(count);
+
+   // The WIP is in the first row: the commits stored start after it.
+   for (auto row = 1; row <= count; ++row)
+   {
+      QStringList parents;
+      parents.reserve(commits.parentLinksCount(row));
+
+      for (auto i = 0; i < commits.parentLinksCount(row); ++i)
+         parents.append(commits.parent(row, i).toSha());
+
+      out << commits.sha(row) << parents << commits.committer(row) << commits.author(row) << commits.date(row)
+          << commits.shortLog(row) << commits.longLog(row) << commits.gpgKey(row) << commits.verifiedSignature(row);
+   }
+}
+
+void HistorySnapshot::remove() const
+{
+   QFile::remove(mFilePath);
+}
+
+QVector<CommitInfo> HistorySnapshot::takeCommits()
+{
+   return std::move(mCommits);
+}
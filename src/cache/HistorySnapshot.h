@@ -0,0 +1,114 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <CommitPages.h>
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+class QDataStream;
+
+/**
+ * @brief The HistorySnapshot class is a serialized cache in disk of the commits of a repository already parsed, so the
+ * history can be shown when the repository is opened again without asking Git for the whole log. The lanes are not
+ * stored: they are calculated by the cache when needed.
+ *
+ * The snapshot is identified by the tips of the references it was built from and the settings that change the content
+ * of the log. It's read sequentially and all its commits are deserialized when it's loaded.
+ *
+ * The file is a list of segments, each one with the tips of the references and the commits added on top of the
+ * previous segment. An incremental update only appends the new commits instead of writing the whole history again.
+ *
+ * @class HistorySnapshot HistorySnapshot.h "HistorySnapshot.h"
+ */
+class HistorySnapshot
+{
+public:
+   /**
+    * @brief Builds the snapshot of the file in @p filePath. Nothing is read until @ref load is called.
+    * @param filePath The absolute path to the snapshot file.
+    */
+   explicit HistorySnapshot(const QString &filePath);
+
+   /**
+    * @brief Loads the snapshot from disk.
+    * @param settingsKey The settings the snapshot must have been created with.
+    * @return True if the file exists, has the current version and matches the @p settingsKey, otherwise false.
+    */
+   bool load(const QString &settingsKey);
+
+   /**
+    * @brief Writes the snapshot to disk, replacing the file. The commits are read from the pages of the cache without
+    * building them. The WIP is skipped.
+    * @param settingsKey The settings used to build the log.
+    * @param tips The references and the SHA they pointed to when the log was built.
+    * @param commits The commits in the order they have in the cache.
+    * @return True if the file was written, otherwise false.
+    */
+   bool save(const QString &settingsKey, const QMap<QString, QString> &tips, const CommitPages &commits) const;
+
+   /**
+    * @brief Appends a segment to the snapshot in disk with the commits added on top of the history since it was saved.
+    * @param tips The references and the SHA they point to now.
+    * @param commits The commits in the order they have in the cache.
+    * @param count The number of commits after the WIP that are not in the snapshot yet.
+    * @return True if the segment was written, otherwise false.
+    */
+   bool append(const QMap<QString, QString> &tips, const CommitPages &commits, int count) const;
+
+   /**
+    * @brief Deletes the snapshot from disk.
+    */
+   void remove() const;
+
+   /**
+    * @brief Returns the references and the SHA they were pointing to when the snapshot was saved.
+    */
+   QMap<QString, QString> tips() const { return mTips; }
+
+   /**
+    * @brief Returns the number of segments read by @ref load.
+    */
+   int segments() const { return mSegments; }
+
+   /**
+    * @brief Returns the commits of the snapshot and releases them from the object.
+    */
+   QVector<CommitInfo> takeCommits();
+
+private:
+   static const quint32 MAGIC;
+   static const quint32 VERSION;
+
+   QString mFilePath;
+   QMap<QString, QString> mTips;
+   QVector<CommitInfo> mCommits;
+   int mSegments = 0;
+
+   static void writeSegment(QDataStream &out, const QMap<QString, QString> &tips, const CommitPages &commits,
+                            int count);
+};
@@ -23,7 +23,9 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-enum class LaneType;
+#include <QtGlobal>
+
+enum class LaneType : quint8;
 
 class Lane
 {
@@ -1,6 +1,9 @@
 #pragma once
 
-enum class LaneType
+#include <QtGlobal>
+
+// One byte per lane: the checkpoints of the graph and the rows kept for painting are stored as arrays of lanes.
+enum class LaneType : quint8
 {
    EMPTY,
    ACTIVE,
@@ -0,0 +1,104 @@
+#include "ObjectId.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+int hexValue(QChar character)
+{
+   const auto c = character.unicode();
+
+   if (c >= '0' && c <= '9')
+      return c - '0';
+   if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+   if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+
+   return -1;
+}
+}
+
+ObjectId ObjectId::fromSha(const QString &sha, bool *ok)
+{
+   ObjectId oid;
+   auto digits = 0;
+   const auto valid = parse(sha, oid, digits, 0) && digits == SIZE * 2;
+
+   if (!valid)
+      oid.mBytes.fill(0);
+
+   if (ok)
+      *ok = valid;
+
+   return oid;
+}
+
+bool ObjectId::parse(const QString &sha, ObjectId &oid, int &digits, quint8 padding)
+{
+   digits = sha.length();
+
+   if (digits > SIZE * 2)
+      return false;
+
+   oid.mBytes.fill(padding);
+
+   for (auto i = 0; i < digits; ++i)
+   {
+      const auto value = hexValue(sha.at(i));
+
+      if (value == -1)
+         return false;
+
+      auto &byte = oid.mBytes[i / 2];
+
+      // The padding of the half byte that is set is replaced: the high half for even digits and the low one for odd.
+      if (i % 2 == 0)
+         byte = static_cast<quint8>((value << 4) | (byte & 0x0f));
+      else
+         byte = static_cast<quint8>((byte & 0xf0) | value);
+   }
+
+   return true;
+}
+
+QString ObjectId::toSha() const
+{
+   static const char digits[] = "0123456789abcdef";
+
+   QString sha(SIZE * 2, Qt::Uninitialized);
+   auto data = sha.data();
+
+   for (const auto byte : mBytes)
+   {
+      *data++ = QLatin1Char(digits[byte >> 4]);
+      *data++ = QLatin1Char(digits[byte & 0x0f]);
+   }
+
+   return sha;
+}
+
+quint64 ObjectId::prefix() const
+{
+   quint64 id = 0;
+
+   for (auto i = 0; i < 8; ++i)
+      id = (id << 8) | mBytes[i];
+
+   return id;
+}
+
+bool ObjectId::isNull() const
+{
+   return std::all_of(mBytes.cbegin(), mBytes.cend(), [](quint8 byte) { return byte == 0; });
+}
+
+uint qHash(const ObjectId &oid, uint seed)
+{
+   // The bytes of a SHA-1 are already uniformly distributed.
+   uint value;
+   memcpy(&value, &oid, sizeof(value));
+
+   return value ^ seed;
+}
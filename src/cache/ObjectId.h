@@ -0,0 +1,80 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+
+#include <array>
+
+/**
+ * @brief The ObjectId class stores the SHA-1 of a Git object as its 20 binary bytes instead of 40 hexadecimal
+ * characters in UTF-16. A default constructed id has all the bytes set to zero, the same as the WIP.
+ *
+ * @class ObjectId ObjectId.h "ObjectId.h"
+ */
+class ObjectId
+{
+public:
+   static const int SIZE = 20;
+
+   ObjectId() { mBytes.fill(0); }
+
+   /**
+    * @brief Builds the id of a full SHA in hexadecimal.
+    * @param sha The SHA with 40 hexadecimal digits.
+    * @param ok Set to false if @p sha is not a full SHA. In that case the id is zero.
+    */
+   static ObjectId fromSha(const QString &sha, bool *ok = nullptr);
+
+   /**
+    * @brief Converts the hexadecimal digits of @p sha, that can be abbreviated, to binary.
+    * @param sha The full or abbreviated SHA.
+    * @param oid The id with the digits of @p sha. The half bytes not given by @p sha are set to @p padding.
+    * @param digits The number of digits of @p sha.
+    * @param padding The value of the bytes after the digits of @p sha.
+    * @return False if @p sha is too long or has any character that is not an hexadecimal digit.
+    */
+   static bool parse(const QString &sha, ObjectId &oid, int &digits, quint8 padding);
+
+   QString toSha() const;
+
+   /**
+    * @brief Returns the first 64 bits of the id. It's the same value Lanes::shaId returns for the SHA.
+    */
+   quint64 prefix() const;
+
+   bool isNull() const;
+
+   bool operator==(const ObjectId &other) const { return mBytes == other.mBytes; }
+   bool operator!=(const ObjectId &other) const { return mBytes != other.mBytes; }
+   bool operator<(const ObjectId &other) const { return mBytes < other.mBytes; }
+   bool operator<=(const ObjectId &other) const { return mBytes <= other.mBytes; }
+
+private:
+   std::array<quint8, SIZE> mBytes;
+};
+
+Q_DECLARE_TYPEINFO(ObjectId, Q_PRIMITIVE_TYPE);
+
+uint qHash(const ObjectId &oid, uint seed = 0);
@@ -70,6 +70,22 @@ bool RevisionFiles::operator!=(const RevisionFiles &revFiles) const
    return !(*this == revFiles);
 }
 
+int RevisionFiles::memoryCost() const
+{
+   // An approximation in bytes: the text of the files plus the status vectors.
+   auto cost = static_cast<int>(sizeof(RevisionFiles));
+
+   for (const auto &file : mFiles)
+      cost += static_cast<int>(sizeof(QString)) + file.size() * static_cast<int>(sizeof(QChar));
+
+   for (const auto &file : mRenamedFiles)
+      cost += static_cast<int>(sizeof(QString)) + file.size() * static_cast<int>(sizeof(QChar));
+
+   cost += (mFileStatus.size() + mergeParent.size()) * static_cast<int>(sizeof(int));
+
+   return cost;
+}
+
 bool RevisionFiles::statusCmp(int idx, RevisionFiles::StatusFlag sf) const
 {
    if (idx >= mFileStatus.count())
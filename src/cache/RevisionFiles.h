@@ -46,6 +46,7 @@ public:
    QString getFile(int index) const { return mFiles.at(index); }
    QStringList getFiles() const { return mFiles.toList(); }
    bool containsFile(const QString &fileName) { return mFiles.contains(fileName); }
+   int memoryCost() const;
 
 private:
    // Status information is split in a flags vector and in a string
@@ -0,0 +1,129 @@
+#include "ShaIndex.h"
+
+#include <algorithm>
+
+const int ShaIndex::MIN_ABBREVIATION = 4;
+
+void ShaIndex::clear()
+{
+   mOids.clear();
+   mOids.squeeze();
+   mSorted = false;
+}
+
+void ShaIndex::reserve(int count)
+{
+   mOids.reserve(count);
+   mSorted = false;
+}
+
+void ShaIndex::sort()
+{
+   if (mSorted)
+      return;
+
+   std::sort(mOids.begin(), mOids.end());
+   mOids.erase(std::unique(mOids.begin(), mOids.end()), mOids.end());
+
+   mSorted = true;
+}
+
+void ShaIndex::insert(const QString &sha)
+{
+   auto valid = false;
+   const auto oid = ObjectId::fromSha(sha, &valid);
+
+   if (!valid)
+      return;
+
+   if (!mSorted)
+      mOids.append(oid);
+   else if (const auto iter = std::lower_bound(mOids.begin(), mOids.end(), oid); iter == mOids.end() || *iter != oid)
+      mOids.insert(iter, oid);
+}
+
+void ShaIndex::remove(const QString &sha)
+{
+   auto valid = false;
+   const auto oid = ObjectId::fromSha(sha, &valid);
+
+   if (!valid)
+      return;
+
+   sort();
+
+   if (const auto iter = std::lower_bound(mOids.begin(), mOids.end(), oid); iter != mOids.end() && *iter == oid)
+      mOids.erase(iter);
+}
+
+ShaIndex::Match ShaIndex::find(const QString &abbreviatedSha) const
+{
+   // Two matches are enough to know that the abbreviation is ambiguous.
+   const auto oids = matches(abbreviatedSha, 2);
+
+   Match match;
+
+   if (oids.count() == 1)
+   {
+      match.type = MatchType::Unique;
+      match.sha = oids.constFirst().toSha();
+   }
+   else if (oids.count() > 1)
+      match.type = MatchType::Ambiguous;
+
+   return match;
+}
+
+QVector<QString> ShaIndex::findAll(const QString &abbreviatedSha) const
+{
+   const auto oids = matches(abbreviatedSha, -1);
+
+   QVector<QString> shas;
+   shas.reserve(oids.count());
+
+   for (const auto &oid : oids)
+      shas.append(oid.toSha());
+
+   return shas;
+}
+
+QVector<ObjectId> ShaIndex::matches(const QString &abbreviatedSha, int limit) const
+{
+   ObjectId lowest;
+   ObjectId highest;
+   auto digits = 0;
+   QVector<ObjectId> oids;
+
+   if (abbreviatedSha.length() < MIN_ABBREVIATION || !ObjectId::parse(abbreviatedSha, lowest, digits, 0x00)
+       || !ObjectId::parse(abbreviatedSha, highest, digits, 0xff))
+   {
+      return oids;
+   }
+
+   // All the SHAs that start with the abbreviation are between the abbreviation padded with zeros and padded with ones.
+   if (mSorted)
+   {
+      const auto last = std::upper_bound(mOids.cbegin(), mOids.cend(), highest);
+
+      for (auto iter = std::lower_bound(mOids.cbegin(), mOids.cend(), lowest); iter != last && oids.count() != limit;
+           ++iter)
+      {
+         oids.append(*iter);
+      }
+   }
+   else
+   {
+      for (const auto &oid : mOids)
+      {
+         if (!(oid < lowest) && !(highest < oid))
+         {
+            oids.append(oid);
+
+            if (oids.count() == limit)
+               break;
+         }
+      }
+   }
+
+   return oids;
+}
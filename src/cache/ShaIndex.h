@@ -0,0 +1,111 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The ShaIndex class keeps the SHAs of the commits as a sorted array of binary object ids so abbreviated SHAs
+ * can be resolved with a binary search instead of comparing them against every SHA of the repository.
+ *
+ * The SHAs added after clearing or reserving the index are appended and sorted at once when @ref sort is called. Until
+ * then, the lookups compare every SHA. Once sorted, new SHAs are inserted in their position. The lookups never modify
+ * the index, so they can run concurrently as long as no SHA is added or removed meanwhile.
+ *
+ * @class ShaIndex ShaIndex.h "ShaIndex.h"
+ */
+class ShaIndex
+{
+public:
+   /**
+    * @brief The MatchType enum describes the result of looking for an abbreviated SHA.
+    */
+   enum class MatchType
+   {
+      None,
+      Unique,
+      Ambiguous
+   };
+
+   /**
+    * @brief The Match struct contains the result of a lookup. The SHA is only set if the match is unique.
+    */
+   struct Match
+   {
+      MatchType type = MatchType::None;
+      QString sha;
+   };
+
+   /**
+    * @brief Minimum number of hexadecimal digits that are accepted as an abbreviated SHA. Same as Git.
+    */
+   static const int MIN_ABBREVIATION;
+
+   /**
+    * @brief Removes all the SHAs from the index. The SHAs added next are not sorted until @ref sort is called.
+    */
+   void clear();
+
+   /**
+    * @brief Reserves memory for @p count SHAs. The SHAs added next are not sorted until @ref sort is called.
+    */
+   void reserve(int count);
+
+   /**
+    * @brief Sorts the SHAs added since the index was cleared or reserved.
+    */
+   void sort();
+
+   /**
+    * @brief Adds a full SHA to the index. SHAs with a different format are ignored.
+    */
+   void insert(const QString &sha);
+
+   /**
+    * @brief Removes a full SHA from the index.
+    */
+   void remove(const QString &sha);
+
+   /**
+    * @brief Looks for the SHA that starts with @p abbreviatedSha.
+    * @param abbreviatedSha The beginning of the SHA, in hexadecimal, with at least @ref MIN_ABBREVIATION digits.
+    * @return The match. If more than one SHA starts with @p abbreviatedSha, the result is ambiguous.
+    */
+   Match find(const QString &abbreviatedSha) const;
+
+   /**
+    * @brief Returns all the SHAs that start with @p abbreviatedSha.
+    * @param abbreviatedSha The beginning of the SHA, in hexadecimal, with at least @ref MIN_ABBREVIATION digits.
+    */
+   QVector<QString> findAll(const QString &abbreviatedSha) const;
+
+private:
+   QVector<ObjectId> mOids;
+   bool mSorted = true;
+
+   QVector<ObjectId> matches(const QString &abbreviatedSha, int limit) const;
+};
@@ -10,7 +10,14 @@
 
 #include <QStringList>
 
-void Lanes::init(const QString &expectedSha)
+#include <algorithm>
+
+bool Lanes::operator==(const Lanes &lanes) const
+{
+   return activeLane == lanes.activeLane && typeVec == lanes.typeVec && nextShaVec == lanes.nextShaVec;
+}
+
+void Lanes::init(quint64 expectedSha)
 {
    clear();
    activeLane = 0;
@@ -23,9 +30,10 @@ void Lanes::clear()
    typeVec.squeeze();
    nextShaVec.clear();
    nextShaVec.squeeze();
+   nextShaLanes.clear();
 }
 
-bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
+bool Lanes::isFork(quint64 sha, bool &isDiscontinuity)
 {
    int pos = findNextSha(sha, 0);
    isDiscontinuity = activeLane != pos;
@@ -33,7 +41,7 @@ bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
    return pos == -1 ? false : findNextSha(sha, pos + 1) != -1;
 }
 
-void Lanes::setFork(const QString &sha)
+void Lanes::setFork(quint64 sha)
 {
    auto rangeEnd = 0;
    auto idx = 0;
@@ -79,7 +87,7 @@ void Lanes::setFork(const QString &sha)
    }
 }
 
-void Lanes::setMerge(const QStringList &parents)
+void Lanes::setMerge(const QVector<quint64> &parents)
 {
    auto &t = typeVec[activeLane];
    auto wasFork = t.equals(NODE);
@@ -92,11 +100,12 @@ void Lanes::setMerge(const QStringList &parents)
 
    auto rangeStart = activeLane;
    auto rangeEnd = activeLane;
-   QStringList::const_iterator it(parents.constBegin());
+   auto it = parents.constBegin();
 
    for (++it; it != parents.constEnd(); ++it)
    { // skip first parent
-      int idx = findNextSha(*it, 0);
+      const auto parent = *it;
+      int idx = findNextSha(parent, 0);
 
       if (idx != -1)
       {
@@ -115,7 +124,7 @@ void Lanes::setMerge(const QStringList &parents)
          typeVec[idx].setType(LaneType::JOIN);
       }
       else
-         rangeEnd = add(LaneType::HEAD, *it, rangeEnd + 1);
+         rangeEnd = add(LaneType::HEAD, parent, rangeEnd + 1);
    }
 
    auto &startT = typeVec[rangeStart];
@@ -160,7 +169,7 @@ void Lanes::setInitial()
       t.setType(LaneType::INITIAL);
 }
 
-void Lanes::changeActiveLane(const QString &sha)
+void Lanes::changeActiveLane(quint64 sha)
 {
    auto &t = typeVec[activeLane];
 
@@ -211,7 +220,7 @@ void Lanes::afterFork()
    while (typeVec.last().equals(LaneType::EMPTY))
    {
       typeVec.pop_back();
-      nextShaVec.pop_back();
+      removeLastNextSha();
    }
 }
 
@@ -228,20 +237,21 @@ void Lanes::afterBranch()
    typeVec[activeLane].setType(LaneType::ACTIVE);
 }
 
-void Lanes::nextParent(const QString &sha)
+void Lanes::nextParent(quint64 sha)
 {
-   nextShaVec[activeLane] = sha;
+   setNextSha(activeLane, sha);
 }
 
-int Lanes::findNextSha(const QString &next, int pos)
+int Lanes::findNextSha(quint64 next, int pos) const
 {
-   for (int i = pos; i < nextShaVec.count(); i++)
-   {
-      if (nextShaVec[i] == next)
-         return i;
-   }
+   const auto lanes = nextShaLanes.constFind(next);
 
-   return -1;
+   if (lanes == nextShaLanes.cend())
+      return -1;
+
+   const auto iter = std::lower_bound(lanes->cbegin(), lanes->cend(), pos);
+
+   return iter != lanes->cend() ? *iter : -1;
 }
 
 int Lanes::findType(const LaneType type, int pos)
@@ -257,7 +267,7 @@ int Lanes::findType(const LaneType type, int pos)
    return -1;
 }
 
-int Lanes::add(const LaneType type, const QString &next, int pos)
+int Lanes::add(const LaneType type, quint64 next, int pos)
 {
    if (pos < typeVec.count())
    {
@@ -265,17 +275,82 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
       if (pos != -1)
       {
          typeVec[pos].setType(type);
-         nextShaVec[pos] = next;
+         setNextSha(pos, next);
          return pos;
       }
    }
 
    typeVec.append(type);
-   nextShaVec.append(next);
+   appendNextSha(next);
    return typeVec.count() - 1;
 }
 
+void Lanes::setNextSha(int pos, quint64 sha)
+{
+   const auto previous = nextShaVec.at(pos);
+
+   if (previous == sha)
+      return;
+
+   auto &previousLanes = nextShaLanes[previous];
+   previousLanes.erase(std::lower_bound(previousLanes.begin(), previousLanes.end(), pos));
+
+   if (previousLanes.isEmpty())
+      nextShaLanes.remove(previous);
+
+   auto &lanes = nextShaLanes[sha];
+   lanes.insert(std::lower_bound(lanes.begin(), lanes.end(), pos), pos);
+
+   nextShaVec[pos] = sha;
+}
+
+void Lanes::appendNextSha(quint64 sha)
+{
+   // The new lane is the last one, so it's also the last lane of its id.
+   nextShaLanes[sha].append(nextShaVec.count());
+   nextShaVec.append(sha);
+}
+
+void Lanes::removeLastNextSha()
+{
+   const auto sha = nextShaVec.takeLast();
+   auto &lanes = nextShaLanes[sha];
+
+   lanes.removeLast();
+
+   if (lanes.isEmpty())
+      nextShaLanes.remove(sha);
+}
+
 bool Lanes::isNode(Lane lane) const
 {
    return lane.equals(NODE) || lane.equals(NODE_R) || lane.equals(NODE_L);
 }
+
+quint64 Lanes::shaId(const QString &sha)
+{
+   if (sha.isEmpty())
+      return NO_SHA;
+
+   const auto digits = std::min(sha.length(), 16);
+   quint64 id = 0;
+
+   for (int i = 0; i < digits; i++)
+   {
+      const auto c = sha.at(i).unicode();
+      quint64 value;
+
+      if (c >= '0' && c <= '9')
+         value = c - '0';
+      else if (c >= 'a' && c <= 'f')
+         value = c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+         value = c - 'A' + 10;
+      else
+         return qHash(sha);
+
+      id = (id << 4) | value;
+   }
+
+   return id;
+}
@@ -7,6 +7,7 @@
 #ifndef LANES_H
 #define LANES_H
 
+#include <QHash>
 #include <QString>
 #include <QVector>
 
@@ -15,7 +16,7 @@
 
 //
 //  At any given time, the Lanes class represents a single revision (row) of the history graph.
-//  The Lanes class contains a vector of the sha1 hashes of the next commit to appear in each lane (column).
+//  The Lanes class contains a vector of the ids of the sha1 hashes of the next commit to appear in each lane (column).
 //  The Lanes class also contains a vector used to decide which glyph to draw on the history graph.
 //
 //  For each revision (row) (from recent (top) to ancient past (bottom)), the Lanes class is updated, and the
@@ -23,36 +24,51 @@
 //
 //  The ListView class is responsible for rendering the glyphs.
 //
+//  The commits are identified by an integer built from the beginning of their sha1 (see shaId()). A hash from that id
+//  to the lanes where the commit is expected is kept in sync with nextShaVec, so looking for the lanes of a commit
+//  doesn't go through all the open lanes.
+//
 
 class Lanes
 {
 public:
    Lanes() = default;
+   bool operator==(const Lanes &lanes) const;
    bool isEmpty() { return typeVec.empty(); }
-   void init(const QString &expectedSha);
+   void init(quint64 expectedSha);
    void clear();
-   bool isFork(const QString &sha, bool &isDiscontinuity);
-   void setFork(const QString &sha);
-   void setMerge(const QStringList &parents);
+   bool isFork(quint64 sha, bool &isDiscontinuity);
+   void setFork(quint64 sha);
+   void setMerge(const QVector<quint64> &parents);
    void setInitial();
-   void changeActiveLane(const QString &sha);
+   void changeActiveLane(quint64 sha);
    void afterMerge();
    void afterFork();
    bool isBranch();
    void afterBranch();
-   void nextParent(const QString &sha);
+   void nextParent(quint64 sha);
    void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
    QVector<Lane> getLanes() const { return typeVec; }
 
+   // The first 64 bits of the sha1. A collision between two commits of the open lanes is negligible.
+   static quint64 shaId(const QString &sha);
+
+   // The id of the parent of the commits that don't have any.
+   static constexpr quint64 NO_SHA = ~Q_UINT64_C(0);
+
 private:
-   int findNextSha(const QString &next, int pos);
+   int findNextSha(quint64 next, int pos) const;
    int findType(LaneType type, int pos);
-   int add(LaneType type, const QString &next, int pos);
+   int add(LaneType type, quint64 next, int pos);
+   void setNextSha(int pos, quint64 sha);
+   void appendNextSha(quint64 sha);
+   void removeLastNextSha();
    bool isNode(Lane lane) const;
 
-   int activeLane;
+   int activeLane = 0;
    QVector<Lane> typeVec; // Describes which glyphs should be drawn.
-   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QVector<quint64> nextShaVec; // The ids of the next commit to appear in each lane (column).
+   QHash<quint64, QVector<int>> nextShaLanes; // The lanes of each id in nextShaVec, sorted.
    LaneType NODE = LaneType::MERGE_FORK;
    LaneType NODE_R = LaneType::MERGE_FORK_R;
    LaneType NODE_L = LaneType::MERGE_FORK_L;
@@ -66,6 +66,7 @@ void CommitInfoWidget::configure(const QString &sha)
          mInfoPanel->configure(commit);
 
          mFileListWidget->insertFiles(mCurrentSha, mParentSha);
+         mCache->prefetchRevisionFiles(mCurrentSha);
       }
    }
 }
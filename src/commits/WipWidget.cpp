@@ -96,8 +96,8 @@ void WipWidget::commitChanges()
                newCommit.longLog = ui->teDescription->toPlainText();
 
                mCache->insertCommit(newCommit);
-               mCache->deleteReference(lastShaBeforeCommit, References::Type::LocalBranch, mGit->getCurrentBranch());
-               mCache->insertReference(currentSha, References::Type::LocalBranch, mGit->getCurrentBranch());
+               mCache->moveReference(lastShaBeforeCommit, currentSha, References::Type::LocalBranch,
+                                     mGit->getCurrentBranch());
 
                QScopedPointer<GitHistory> gitHistory(new GitHistory(mGit));
                const auto ret = gitHistory->getDiffFiles(currentSha, lastShaBeforeCommit);
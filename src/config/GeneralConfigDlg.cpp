@@ -1,5 +1,6 @@
 #include "GeneralConfigDlg.h"
 
+#include <AGitProcess.h>
 #include <GitQlientSettings.h>
 #include <GitQlientStyles.h>
 #include <QLogger.h>
@@ -108,6 +109,7 @@ void GeneralConfigDlg::accept()
    mSettings->setGlobalValue("logsLevel", mLevelCombo->currentIndex());
    mSettings->setGlobalValue("colorSchema", mStylesSchema->currentText());
    mSettings->setGlobalValue("gitLocation", mGitLocation->text());
+   AGitProcess::resetGitLocation();
 
    if (mShowResetMsg)
       QMessageBox::information(this, tr("Reset needed!"),
@@ -3,6 +3,7 @@ INCLUDEPATH += $$PWD
 HEADERS += \
     $$PWD/DiffHelper.h \
     $$PWD/DiffInfo.h \
+    $$PWD/FileBlameView.h \
     $$PWD/FileBlameWidget.h \
     $$PWD/FileDiffEditor.h \
     $$PWD/FileDiffHighlighter.h \
@@ -14,6 +15,7 @@ HEADERS += \
     $$PWD/LineNumberArea.h
 
 SOURCES += \
+    $$PWD/FileBlameView.cpp \
     $$PWD/FileBlameWidget.cpp \
     $$PWD/FileDiffEditor.cpp \
     $$PWD/FileDiffHighlighter.cpp \
@@ -0,0 +1,277 @@
+#include "FileBlameView.h"
+
+#include <GitQlientStyles.h>
+
+#include <QEvent>
+#include <QHelpEvent>
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QToolTip>
+
+#include <algorithm>
+
+namespace
+{
+static const auto kPadding = 5;
+static const auto kAnnotationPadding = 15;
+static const auto kVerticalPadding = 4;
+static const auto kChangeBorderWidth = 5;
+}
+
+FileBlameView::FileBlameView(QWidget *parent)
+   : QAbstractScrollArea(parent)
+{
+   setObjectName("AnnotationFrame");
+   setFrameShape(QFrame::NoFrame);
+   viewport()->setMouseTracking(true);
+
+   mInfoFont.setPointSize(9);
+
+   mCodeFont = QFont(mInfoFont);
+   mCodeFont.setFamily("DejaVu Sans Mono");
+   mCodeFont.setPointSize(8);
+
+   mRowHeight = qMax(QFontMetrics(mInfoFont).height(), QFontMetrics(mCodeFont).height()) + 2 * kVerticalPadding;
+}
+
+void FileBlameView::setBlame(const QVector<Run> &runs, const QStringList &lines)
+{
+   // Every line belongs to a block: the first block must start at the first line.
+   Q_ASSERT(lines.isEmpty() || (!runs.isEmpty() && runs.constFirst().firstLine == 0));
+
+   mRuns = runs;
+   mLines = lines;
+   mHoveredRun = -1;
+   mPressedRun = -1;
+
+   // The columns are measured once per block, not per line.
+   const QFontMetrics infoMetrics(mInfoFont);
+   mDateWidth = 0;
+   mAuthorWidth = 0;
+   mMessageWidth = 0;
+
+   for (const auto &run : qAsConst(mRuns))
+   {
+      mDateWidth = qMax(mDateWidth, infoMetrics.horizontalAdvance(run.when));
+      mAuthorWidth = qMax(mAuthorWidth, infoMetrics.horizontalAdvance(run.author));
+      mMessageWidth = qMax(mMessageWidth, infoMetrics.horizontalAdvance(run.message));
+   }
+
+   mDateWidth += kPadding + kAnnotationPadding;
+   mAuthorWidth += kPadding + kAnnotationPadding;
+   mMessageWidth += kPadding + kAnnotationPadding;
+
+   const QFontMetrics codeMetrics(mCodeFont);
+   mNumberWidth = kChangeBorderWidth + 2 * kPadding
+       + codeMetrics.horizontalAdvance(QString::number(mLines.count())) + 1;
+
+   // The code font is monospaced: only the longest line needs to be measured.
+   const auto longestLine = std::max_element(mLines.cbegin(), mLines.cend(), [](const QString &a, const QString &b) {
+      return a.length() < b.length();
+   });
+
+   mCodeWidth = longestLine == mLines.cend()
+       ? 0
+       : codeMetrics.boundingRect(QRect(), Qt::TextExpandTabs, *longestLine).width() + 2 * kPadding;
+
+   verticalScrollBar()->setValue(0);
+   horizontalScrollBar()->setValue(0);
+   updateScrollBars();
+
+   viewport()->update();
+}
+
+void FileBlameView::paintEvent(QPaintEvent *event)
+{
+   Q_UNUSED(event);
+
+   QPainter painter(viewport());
+   painter.setPen(GitQlientStyles::getTextColor());
+
+   if (mLines.isEmpty() || mRuns.isEmpty())
+   {
+      painter.setFont(mInfoFont);
+      painter.drawText(viewport()->rect(), Qt::AlignCenter, tr("Select a file to blame"));
+      return;
+   }
+
+   const auto numberX = mDateWidth + mAuthorWidth + mMessageWidth;
+   const auto codeX = numberX + mNumberWidth;
+   const auto firstLine = verticalScrollBar()->value();
+   const auto lastLine = qMin(mLines.count(), firstLine + viewport()->height() / mRowHeight + 1);
+
+   painter.fillRect(QRect(0, 0, codeX, viewport()->height()), GitQlientStyles::getBlameInfoBackgroundColor());
+   painter.fillRect(QRect(codeX, 0, viewport()->width() - codeX, viewport()->height()),
+                    GitQlientStyles::getBackgroundColor());
+
+   auto run = runOfLine(firstLine);
+
+   for (auto line = firstLine; line < lastLine; ++line)
+   {
+      const auto y = (line - firstLine) * mRowHeight;
+
+      if (run + 1 < mRuns.count() && mRuns.at(run + 1).firstLine == line)
+         ++run;
+
+      // The information of a block is shown in its first line, or in the first visible one when it starts above.
+      if (line == mRuns.at(run).firstLine || line == firstLine)
+         paintRun(painter, run, y);
+
+      painter.fillRect(QRect(numberX, y, kChangeBorderWidth, mRowHeight), mRuns.at(run).color);
+      painter.setFont(mCodeFont);
+      painter.drawText(QRect(numberX, y, mNumberWidth - kPadding - 1, mRowHeight), Qt::AlignVCenter | Qt::AlignRight,
+                       QString::number(line + 1));
+
+      painter.save();
+      painter.setClipRect(QRect(codeX, y, viewport()->width() - codeX, mRowHeight));
+      painter.drawText(QRect(codeX + kPadding - horizontalScrollBar()->value(), y, mCodeWidth, mRowHeight),
+                       Qt::AlignVCenter | Qt::AlignLeft | Qt::TextExpandTabs, mLines.at(line));
+      painter.restore();
+   }
+
+   painter.setPen(GitQlientStyles::getBlameNumberBorderColor());
+   painter.drawLine(codeX - 1, 0, codeX - 1, (lastLine - firstLine) * mRowHeight);
+}
+
+void FileBlameView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void FileBlameView::mouseMoveEvent(QMouseEvent *event)
+{
+   const auto run = columnAt(event->pos().x()) == Column::Message ? runAt(event->pos().y()) : -1;
+
+   if (run != mHoveredRun)
+   {
+      mHoveredRun = run;
+
+      if (mHoveredRun == -1)
+         viewport()->unsetCursor();
+      else
+         viewport()->setCursor(Qt::PointingHandCursor);
+
+      viewport()->update();
+   }
+}
+
+void FileBlameView::mousePressEvent(QMouseEvent *event)
+{
+   if (event->button() == Qt::LeftButton)
+      mPressedRun = mHoveredRun;
+}
+
+void FileBlameView::mouseReleaseEvent(QMouseEvent *event)
+{
+   if (event->button() == Qt::LeftButton && mPressedRun != -1 && mPressedRun == mHoveredRun)
+      emit signalCommitSelected(mRuns.at(mPressedRun).sha);
+
+   mPressedRun = -1;
+}
+
+bool FileBlameView::viewportEvent(QEvent *event)
+{
+   if (event->type() == QEvent::ToolTip)
+   {
+      const auto helpEvent = static_cast<QHelpEvent *>(event);
+      const auto column = columnAt(helpEvent->pos().x());
+      const auto run = runAt(helpEvent->pos().y());
+      QString toolTip;
+
+      if (run != -1 && column == Column::Date)
+         toolTip = mRuns.at(run).dateTime.toString("dd/MM/yyyy hh:mm");
+      else if (run != -1 && column == Column::Message)
+         toolTip = QString("<p>%1</p><p>%2</p>").arg(mRuns.at(run).sha, mRuns.at(run).message);
+
+      if (toolTip.isEmpty())
+         QToolTip::hideText();
+      else
+         QToolTip::showText(helpEvent->globalPos(), toolTip, viewport());
+
+      return true;
+   }
+   else if (event->type() == QEvent::Leave && mHoveredRun != -1)
+   {
+      mHoveredRun = -1;
+      viewport()->unsetCursor();
+      viewport()->update();
+   }
+
+   return QAbstractScrollArea::viewportEvent(event);
+}
+
+void FileBlameView::updateScrollBars()
+{
+   const auto visibleLines = qMax(1, viewport()->height() / mRowHeight);
+   const auto codeAreaWidth = viewport()->width() - mDateWidth - mAuthorWidth - mMessageWidth - mNumberWidth;
+
+   verticalScrollBar()->setRange(0, qMax(0, mLines.count() - visibleLines));
+   verticalScrollBar()->setSingleStep(1);
+   verticalScrollBar()->setPageStep(visibleLines);
+
+   horizontalScrollBar()->setRange(0, qMax(0, mCodeWidth - codeAreaWidth));
+   horizontalScrollBar()->setSingleStep(QFontMetrics(mCodeFont).horizontalAdvance(QLatin1Char(' ')));
+   horizontalScrollBar()->setPageStep(qMax(1, codeAreaWidth));
+}
+
+FileBlameView::Column FileBlameView::columnAt(int x) const
+{
+   if (x < mDateWidth)
+      return Column::Date;
+   else if (x < mDateWidth + mAuthorWidth)
+      return Column::Author;
+   else if (x < mDateWidth + mAuthorWidth + mMessageWidth)
+      return Column::Message;
+   else if (x < mDateWidth + mAuthorWidth + mMessageWidth + mNumberWidth)
+      return Column::Number;
+
+   return Column::Code;
+}
+
+int FileBlameView::runAt(int y) const
+{
+   const auto line = verticalScrollBar()->value() + y / mRowHeight;
+
+   return y >= 0 && line < mLines.count() && !mRuns.isEmpty() ? runOfLine(line) : -1;
+}
+
+int FileBlameView::runOfLine(int line) const
+{
+   const auto iter = std::upper_bound(mRuns.cbegin(), mRuns.cend(), line,
+                                      [](int value, const Run &run) { return value < run.firstLine; });
+
+   return qMax(0, static_cast<int>(std::distance(mRuns.cbegin(), iter)) - 1);
+}
+
+void FileBlameView::paintRun(QPainter &painter, int run, int y)
+{
+   const auto &blame = mRuns.at(run);
+   const auto top = y + kVerticalPadding;
+   const auto height = mRowHeight - 2 * kVerticalPadding;
+   auto x = kPadding;
+
+   // The blocks are separated by a line, except the first one of the file.
+   if (const auto line = verticalScrollBar()->value() + y / mRowHeight; line == blame.firstLine && line != 0)
+   {
+      painter.save();
+      painter.setPen(GitQlientStyles::getBlameSeparatorColor());
+      painter.drawLine(0, y, mDateWidth + mAuthorWidth + mMessageWidth - 1, y);
+      painter.restore();
+   }
+
+   auto font = mInfoFont;
+   painter.setFont(font);
+   painter.drawText(QRect(x, top, mDateWidth - kPadding, height), Qt::AlignVCenter | Qt::AlignLeft, blame.when);
+   x += mDateWidth;
+
+   painter.drawText(QRect(x, top, mAuthorWidth - kPadding, height), Qt::AlignVCenter | Qt::AlignLeft, blame.author);
+   x += mAuthorWidth;
+
+   font.setUnderline(run == mHoveredRun);
+   painter.setFont(font);
+   painter.drawText(QRect(x, top, mMessageWidth - kPadding, height), Qt::AlignVCenter | Qt::AlignLeft, blame.message);
+}
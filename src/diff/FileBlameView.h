@@ -0,0 +1,182 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractScrollArea>
+#include <QColor>
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ \brief The FileBlameView class paints the blame of a file. Every block of consecutive lines changed in the same commit
+ is stored once in a table of runs, so the view doesn't need a widget per line. Only the lines visible in the viewport
+ are painted and the scroll is done by lines: its cost doesn't depend on the length of the file.
+
+*/
+class FileBlameView : public QAbstractScrollArea
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the user selects the commit of a block of lines.
+
+    \param sha The SHA of the commit.
+   */
+   void signalCommitSelected(const QString &sha);
+
+public:
+   /*!
+    \brief Stores the information of a block of consecutive lines that were last modified by the same commit.
+
+   */
+   struct Run
+   {
+      int firstLine = 0; /*!< The first line of the block. The block ends where the next one starts. */
+      QString sha;
+      QString author;
+      QDateTime dateTime;
+      QString when; /*!< The time since the commit, as it's shown. */
+      QString message;
+      QColor color; /*!< The color that indicates how recent the change is. */
+   };
+
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit FileBlameView(QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the blame to display.
+
+    \param runs The blocks of the blame, sorted by their first line. The first one starts at the first line.
+    \param lines The content of the file, one entry per line.
+   */
+   void setBlame(const QVector<Run> &runs, const QStringList &lines);
+
+protected:
+   /*!
+    \brief Paints the lines visible in the viewport.
+
+    \param event The paint event.
+   */
+   void paintEvent(QPaintEvent *event) override;
+   /*!
+    \brief Updates the range of the scroll bars to the new size of the viewport.
+
+    \param event The resize event.
+   */
+   void resizeEvent(QResizeEvent *event) override;
+   /*!
+    \brief Highlights the message of the block under the cursor.
+
+    \param event The mouse event.
+   */
+   void mouseMoveEvent(QMouseEvent *event) override;
+   /*!
+    \brief Starts the selection of the commit when the message of a block is pressed.
+
+    \param event The mouse event.
+   */
+   void mousePressEvent(QMouseEvent *event) override;
+   /*!
+    \brief Selects the commit of the block when the message is released after being pressed.
+
+    \param event The mouse event.
+   */
+   void mouseReleaseEvent(QMouseEvent *event) override;
+   /*!
+    \brief Shows the tooltips of the date and the message of the blocks and removes the highlight when the cursor leaves
+    the viewport.
+
+    \param event The event of the viewport.
+    \return Returns true if the event was handled.
+   */
+   bool viewportEvent(QEvent *event) override;
+
+private:
+   /*!
+    \brief The columns of the view, from left to right.
+
+   */
+   enum class Column
+   {
+      Date,
+      Author,
+      Message,
+      Number,
+      Code
+   };
+
+   QVector<Run> mRuns;
+   QStringList mLines;
+   QFont mInfoFont;
+   QFont mCodeFont;
+   int mRowHeight = 0;
+   int mDateWidth = 0;
+   int mAuthorWidth = 0;
+   int mMessageWidth = 0;
+   int mNumberWidth = 0;
+   int mCodeWidth = 0;
+   int mHoveredRun = -1;
+   int mPressedRun = -1;
+
+   /*!
+    \brief Updates the range and the steps of the scroll bars.
+
+   */
+   void updateScrollBars();
+   /*!
+    \brief Retrieves the column at the horizontal position \p x of the viewport.
+
+    \param x The horizontal position.
+    \return The column.
+   */
+   Column columnAt(int x) const;
+   /*!
+    \brief Retrieves the block at the vertical position \p y of the viewport.
+
+    \param y The vertical position.
+    \return The index of the block or -1 if there is no line there.
+   */
+   int runAt(int y) const;
+   /*!
+    \brief Retrieves the block that contains the \p line. It's a binary search in the table of runs.
+
+    \param line The line of the file.
+    \return The index of the block.
+   */
+   int runOfLine(int line) const;
+   /*!
+    \brief Paints the date, the author and the message of a block in the row at \p y.
+
+    \param painter The painter of the viewport.
+    \param run The block to paint.
+    \param y The top of the row.
+   */
+   void paintRun(QPainter &painter, int run, int y);
+};
@@ -1,27 +1,45 @@
 #include "FileBlameWidget.h"
 
-#include <ButtonLink.hpp>
+#include <Colors.h>
 #include <CommitInfo.h>
+#include <FileBlameView.h>
+#include <GitBase.h>
 #include <GitCache.h>
 #include <GitHistory.h>
 
 #include <QGridLayout>
 #include <QLabel>
 #include <QMessageBox>
-#include <QScrollArea>
 #include <QtMath>
 
 #include <array>
+#include <limits>
 
 namespace
 {
 static const int kTotalColors = 8;
-static const std::array<const char *, kTotalColors> kBorderColors { { "25, 65, 99", "36, 95, 146", "44, 116, 177",
-                                                                      "56, 136, 205", "87, 155, 213", "118, 174, 221",
-                                                                      "150, 192, 221", "197, 220, 240" } };
-qint64 kSecondsNewest = 0;
-qint64 kSecondsOldest = QDateTime::currentDateTime().toSecsSinceEpoch();
-qint64 kIncrementSecs = 0;
+static const std::array<QColor, kTotalColors> kBorderColors {
+   { QColor(25, 65, 99), QColor(36, 95, 146), QColor(44, 116, 177), QColor(56, 136, 205), QColor(87, 155, 213),
+     QColor(118, 174, 221), QColor(150, 192, 221), QColor(197, 220, 240) }
+};
+
+QString shortMessage(const QString &message)
+{
+   return message.count() > 47 ? message.left(47) + QString("...") : message;
+}
+
+QString commitSubject(const QByteArray &commitObject)
+{
+   // The message of a commit object starts after the first empty line.
+   const auto start = commitObject.indexOf("\n\n");
+
+   if (start == -1)
+      return QString();
+
+   const auto end = commitObject.indexOf('\n', start + 2);
+
+   return QString::fromUtf8(commitObject.mid(start + 2, end == -1 ? -1 : end - start - 2));
+}
 }
 
 FileBlameWidget::FileBlameWidget(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git,
@@ -29,28 +47,13 @@ FileBlameWidget::FileBlameWidget(const QSharedPointer<GitCache> &cache, const QS
    : QFrame(parent)
    , mCache(cache)
    , mGit(git)
-   , mAnotation(new QFrame())
+   , mBlameView(new FileBlameView())
    , mCurrentSha(new QLabel())
    , mPreviousSha(new QLabel())
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
-   mAnotation->setObjectName("AnnotationFrame");
-
-   auto initialLayout = new QGridLayout(mAnotation);
-   initialLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), 0, 0);
-   initialLayout->addWidget(new QLabel(tr("Select a file to blame")), 1, 1);
-   initialLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), 2, 2);
-
-   mInfoFont.setPointSize(9);
-
-   mCodeFont = QFont(mInfoFont);
-   mCodeFont.setFamily("DejaVu Sans Mono");
-   mCodeFont.setPointSize(8);
-
-   mScrollArea = new QScrollArea();
-   mScrollArea->setWidget(mAnotation);
-   mScrollArea->setWidgetResizable(true);
+   connect(mBlameView, &FileBlameView::signalCommitSelected, this, &FileBlameWidget::signalCommitSelected);
 
    const auto lSha = new QLabel(tr("Current SHA:"));
    const auto lSha2 = new QLabel(tr("Previous SHA:"));
@@ -72,7 +75,7 @@ FileBlameWidget::FileBlameWidget(const QSharedPointer<GitCache> &cache, const QS
    layout->setContentsMargins(10, 10, 10, 0);
    layout->setSpacing(0);
    layout->addLayout(shasLayout);
-   layout->addWidget(mScrollArea);
+   layout->addWidget(mBlameView);
 }
 
 void FileBlameWidget::setup(const QString &fileName, const QString &currentSha, const QString &previousSha)
@@ -83,14 +86,10 @@ void FileBlameWidget::setup(const QString &fileName, const QString &currentSha,
 
    if (ret.success && !ret.output.startsWith("fatal:"))
    {
-      delete mAnotation;
-      mAnotation = nullptr;
-
       mCurrentSha->setText(currentSha);
       mPreviousSha->setText(previousSha);
 
-      const auto annotations = processBlame(ret.output);
-      formatAnnotatedFile(annotations);
+      processBlame(ret.output);
    }
    else
       QMessageBox::warning(
@@ -108,21 +107,32 @@ QString FileBlameWidget::getCurrentSha() const
    return mCurrentSha->text();
 }
 
-QVector<FileBlameWidget::Annotation> FileBlameWidget::processBlame(const QString &blame)
+void FileBlameWidget::processBlame(const QString &blame)
 {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-   const auto lines = blame.split("\n", Qt::SkipEmptyParts);
+   const auto blameLines = blame.split("\n", Qt::SkipEmptyParts);
 #else
-   const auto lines = blame.split("\n", QString::SkipEmptyParts);
+   const auto blameLines = blame.split("\n", QString::SkipEmptyParts);
 #endif
-   QVector<Annotation> annotations;
+   QVector<FileBlameView::Run> runs;
+   QStringList lines;
+   lines.reserve(blameLines.count());
 
-   for (const auto &line : lines)
+   auto secondsNewest = std::numeric_limits<qint64>::min();
+   auto secondsOldest = std::numeric_limits<qint64>::max();
+   QString lastShortSha;
+   QStringList unknownShas;
+   QVector<int> unknownRuns;
+
+   for (const auto &line : blameLines)
    {
       auto start = 0;
       auto indexOfTab = line.indexOf('\t');
-      const auto shortSha = line.mid(start, indexOfTab);
-      const auto revision = mCache->commitInfo(shortSha);
+      auto shortSha = line.mid(start, indexOfTab);
+
+      // Boundary commits are marked with a caret before the SHA.
+      if (shortSha.startsWith('^'))
+         shortSha.remove(0, 1);
 
       start = indexOfTab + 1;
       indexOfTab = line.indexOf('\t', start);
@@ -131,193 +141,107 @@ QVector<FileBlameWidget::Annotation> FileBlameWidget::processBlame(const QString
       start = indexOfTab + 1;
       indexOfTab = line.indexOf('\t', start);
       const auto dtValue = line.mid(start, indexOfTab - start);
-      const auto dt = QDateTime::fromString(dtValue, Qt::ISODate);
 
       start = indexOfTab + 1;
 
       const auto lineNumAndContent = line.mid(start);
       const auto divisorChar = lineNumAndContent.indexOf(")");
       const auto lineText = lineNumAndContent.mid(0, divisorChar);
-      const auto content = lineNumAndContent.mid(divisorChar + 1, lineNumAndContent.count() - lineText.count() - 1);
 
-      annotations.append({ revision.sha, name, dt, lineText.toInt(), content });
+      lines.append(lineNumAndContent.mid(divisorChar + 1, lineNumAndContent.count() - lineText.count() - 1));
 
-      if (revision.sha != CommitInfo::ZERO_SHA)
-      {
-         const auto dtSinceEpoch = dt.toSecsSinceEpoch();
+      // Only the first line of every block creates a run: the rest of them belong to it.
+      if (!runs.isEmpty() && shortSha == lastShortSha)
+         continue;
 
-         if (kSecondsNewest < dtSinceEpoch)
-            kSecondsNewest = dtSinceEpoch;
+      lastShortSha = shortSha;
 
-         if (kSecondsOldest > dtSinceEpoch)
-            kSecondsOldest = dtSinceEpoch;
+      const auto revision = mCache->commitInfo(shortSha);
+      const auto dt = QDateTime::fromString(dtValue, Qt::ISODate);
+      FileBlameView::Run run;
+      run.firstLine = lines.count() - 1;
+      run.sha = revision.sha;
+      run.author = name;
+      run.dateTime = dt;
+      run.message = tr("Local changes");
+
+      if (!revision.sha.isEmpty())
+         run.message = shortMessage(revision.shortLog);
+      else if (shortSha.count('0') != shortSha.count())
+      {
+         unknownShas.append(shortSha);
+         unknownRuns.append(runs.count());
       }
-   }
-
-   kIncrementSecs = kSecondsNewest != kSecondsOldest ? (kSecondsNewest - kSecondsOldest) / (kTotalColors - 1) : 1;
-
-   return annotations;
-}
 
-void FileBlameWidget::formatAnnotatedFile(const QVector<Annotation> &annotations)
-{
-   auto labelRow = 0;
-   auto labelRowSpan = 1;
-   QLabel *dateLabel = nullptr;
-   QLabel *authorLabel = nullptr;
-   ButtonLink *messageLabel = nullptr;
-
-   const auto annotationLayout = new QGridLayout();
-   annotationLayout->setContentsMargins(QMargins());
-   annotationLayout->setSpacing(0);
-
-   const auto totalAnnot = annotations.count();
-   for (auto row = 0; row < totalAnnot; ++row)
-   {
-      const auto &lastAnnotation = row == 0 ? Annotation() : annotations.at(row - 1);
-
-      if (lastAnnotation.sha != annotations.at(row).sha)
+      if (revision.sha != CommitInfo::ZERO_SHA)
       {
-         if (dateLabel)
-            annotationLayout->addWidget(dateLabel, labelRow, 0);
+         run.when = formatWhen(dt);
 
-         if (authorLabel)
-            annotationLayout->addWidget(authorLabel, labelRow, 1);
-
-         if (messageLabel)
-            annotationLayout->addWidget(messageLabel, labelRow, 2);
-
-         dateLabel = createDateLabel(annotations.at(row), row == 0);
-         authorLabel = createAuthorLabel(annotations.at(row).author, row == 0);
-         messageLabel = createMessageLabel(annotations.at(row).sha, row == 0);
-
-         labelRow = row;
-         labelRowSpan = 1;
+         const auto dtSinceEpoch = dt.toSecsSinceEpoch();
+         secondsNewest = qMax(secondsNewest, dtSinceEpoch);
+         secondsOldest = qMin(secondsOldest, dtSinceEpoch);
       }
-      else
-         ++labelRowSpan;
 
-      annotationLayout->addWidget(createNumLabel(annotations.at(row), row), row, 3);
-      annotationLayout->addWidget(createCodeLabel(annotations.at(row).content), row, 4);
+      runs.append(run);
    }
 
-   // Adding the last row
-   if (dateLabel)
-      annotationLayout->addWidget(dateLabel, labelRow, 0);
-
-   if (authorLabel)
-      annotationLayout->addWidget(authorLabel, labelRow, 1);
-
-   if (messageLabel)
-      annotationLayout->addWidget(messageLabel, labelRow, 2);
-
-   annotationLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), totalAnnot, 4);
-
-   mAnotation = new QFrame();
-   mAnotation->setObjectName("AnnotationFrame");
-   mAnotation->setLayout(annotationLayout);
-
-   mScrollArea->setWidget(mAnotation);
-   mScrollArea->setWidgetResizable(true);
-}
-
-QLabel *FileBlameWidget::createDateLabel(const Annotation &annotation, bool isFirst)
-{
-   auto isWip = annotation.sha == CommitInfo::ZERO_SHA;
-   QString when;
-
-   if (!isWip)
+   // The commits that are not in the history loaded (a limited log or another branch) are read from Git at once.
+   if (!unknownShas.isEmpty())
    {
-      const auto days = annotation.dateTime.daysTo(QDateTime::currentDateTime());
-      const auto secs = annotation.dateTime.secsTo(QDateTime::currentDateTime());
-      if (days > 365)
-         when.append(tr("more than 1 year ago"));
-      else if (days > 1)
-         when.append(QString::number(days)).append(tr(" days ago"));
-      else if (days == 1)
-         when.append(tr("yesterday"));
-      else if (secs > 3600)
-         when.append(QString::number(secs / 3600)).append(tr(" hours ago"));
-      else if (secs == 3600)
-         when.append(tr("1 hour ago"));
-      else if (secs > 60)
-         when.append(QString::number(secs / 60)).append(tr(" minutes ago"));
-      else if (secs == 60)
-         when.append(tr("1 minute ago"));
-      else
-         when.append(QString::number(secs)).append(tr(" secs ago"));
+      if (const auto objects = mGit->readObjects(unknownShas))
+      {
+         for (auto i = 0; i < objects->count(); ++i)
+         {
+            if (const auto &object = objects->at(i); object.type == QString("commit"))
+            {
+               auto &run = runs[unknownRuns.at(i)];
+               run.sha = object.sha;
+               run.message = shortMessage(commitSubject(object.content));
+            }
+         }
+      }
    }
 
-   const auto dateLabel = new QLabel(when);
-   dateLabel->setObjectName(isFirst ? QString("authorPrimusInterPares") : QString("authorFirstOfItsName"));
-   dateLabel->setToolTip(annotation.dateTime.toString("dd/MM/yyyy hh:mm"));
-   dateLabel->setFont(mInfoFont);
-   dateLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
-
-   return dateLabel;
-}
-
-QLabel *FileBlameWidget::createAuthorLabel(const QString &author, bool isFirst)
-{
-   const auto authorLabel = new QLabel(author);
-   authorLabel->setObjectName(isFirst ? QString("authorPrimusInterPares") : QString("authorFirstOfItsName"));
-   authorLabel->setFont(mInfoFont);
-   authorLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
-
-   return authorLabel;
-}
+   // The colors go from the newest change to the oldest one.
+   const auto incrementSecs
+       = secondsNewest > secondsOldest ? qMax<qint64>(1, (secondsNewest - secondsOldest) / (kTotalColors - 1)) : 1;
 
-ButtonLink *FileBlameWidget::createMessageLabel(const QString &sha, bool isFirst)
-{
-   const auto revision = mCache->commitInfo(sha);
-   auto commitMsg = tr("Local changes");
-
-   if (!revision.sha.isEmpty())
+   for (auto &run : runs)
    {
-      auto log = revision.shortLog;
-
-      if (log.count() > 47)
-         log = log.left(47) + QString("...");
-
-      commitMsg = log;
+      if (run.sha == CommitInfo::ZERO_SHA)
+         run.color = gitQlientOrange;
+      else
+      {
+         const auto colorIndex = qCeil((secondsNewest - run.dateTime.toSecsSinceEpoch()) / incrementSecs);
+         run.color = kBorderColors.at(static_cast<size_t>(qBound(0, colorIndex, kTotalColors - 1)));
+      }
    }
 
-   const auto messageLabel = new ButtonLink(commitMsg);
-   messageLabel->setObjectName(isFirst ? QString("primusInterPares") : QString("firstOfItsName"));
-   messageLabel->setToolTip(QString("<p>%1</p><p>%2</p>").arg(sha, commitMsg));
-   messageLabel->setFont(mInfoFont);
-
-   connect(messageLabel, &ButtonLink::clicked, this, [this, sha]() { emit signalCommitSelected(sha); });
-
-   return messageLabel;
+   mBlameView->setBlame(runs, lines);
 }
 
-QLabel *FileBlameWidget::createNumLabel(const Annotation &annotation, int row)
+QString FileBlameWidget::formatWhen(const QDateTime &dateTime) const
 {
-   const auto numberLabel = new QLabel(QString::number(row + 1));
-   numberLabel->setFont(mCodeFont);
-   numberLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::MinimumExpanding);
-   numberLabel->setObjectName("numberLabel");
-   numberLabel->setAlignment(Qt::AlignVCenter | Qt::AlignRight);
+   const auto days = dateTime.daysTo(QDateTime::currentDateTime());
+   const auto secs = dateTime.secsTo(QDateTime::currentDateTime());
+   QString when;
 
-   if (annotation.sha != CommitInfo::ZERO_SHA)
-   {
-      const auto dtSinceEpoch = annotation.dateTime.toSecsSinceEpoch();
-      const auto colorIndex = qCeil((kSecondsNewest - dtSinceEpoch) / kIncrementSecs);
-      numberLabel->setStyleSheet(
-          QString("QLabel { border-left: 5px solid rgb(%1) }").arg(QString::fromUtf8(kBorderColors.at(colorIndex))));
-   }
+   if (days > 365)
+      when.append(tr("more than 1 year ago"));
+   else if (days > 1)
+      when.append(QString::number(days)).append(tr(" days ago"));
+   else if (days == 1)
+      when.append(tr("yesterday"));
+   else if (secs > 3600)
+      when.append(QString::number(secs / 3600)).append(tr(" hours ago"));
+   else if (secs == 3600)
+      when.append(tr("1 hour ago"));
+   else if (secs > 60)
+      when.append(QString::number(secs / 60)).append(tr(" minutes ago"));
+   else if (secs == 60)
+      when.append(tr("1 minute ago"));
    else
-      numberLabel->setStyleSheet("QLabel { border-left: 5px solid #D89000 }");
-
-   return numberLabel;
-}
-
-QLabel *FileBlameWidget::createCodeLabel(const QString &content)
-{
-   const auto contentLabel = new QLabel(content);
-   contentLabel->setFont(mCodeFont);
-   contentLabel->setObjectName("normalLabel");
+      when.append(QString::number(secs)).append(tr(" secs ago"));
 
-   return contentLabel;
+   return when;
 }
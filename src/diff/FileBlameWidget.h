@@ -27,10 +27,9 @@
 #include <QDateTime>
 
 class GitBase;
-class QScrollArea;
-class ButtonLink;
 class QLabel;
 class GitCache;
+class FileBlameView;
 
 /*!
  \brief The FileBalmeWidget class is the widget that creates the view for the blame of a file. It is formed by two
@@ -95,79 +94,23 @@ public:
 private:
    QSharedPointer<GitCache> mCache;
    QSharedPointer<GitBase> mGit;
-   QFrame *mAnotation = nullptr;
+   FileBlameView *mBlameView = nullptr;
    QLabel *mCurrentSha = nullptr;
    QLabel *mPreviousSha = nullptr;
-   QScrollArea *mScrollArea = nullptr;
-   QFont mInfoFont;
-   QFont mCodeFont;
    QString mCurrentFile;
 
    /*!
-    \brief Private class that stores data of a annotation. An annotation is the information regarding when a line was
-    last modified.
-
-   */
-   struct Annotation
-   {
-      QString sha;
-      QString author;
-      QDateTime dateTime;
-      int line = 0;
-      QString content;
-   };
-
-   /*!
-    \brief Processes a blame converting the git output into a vector of annotations per each line.
+    \brief Processes a blame converting the git output into the lines of the file and the blocks of lines that were
+    last modified by the same commit. Then, the view displays them.
 
     \param blame The git blame output.
-    \return QVector<Annotation> Vector of the annotations for every line.
-   */
-   QVector<Annotation> processBlame(const QString &blame);
-   /*!
-    \brief Process all the \p annotations and creates the view of the file with that information.
-
-    \param annotations The annotations to process.
-   */
-   void formatAnnotatedFile(const QVector<Annotation> &annotations);
-   /*!
-    \brief Factory method that creates a label with the date and time based on an annotation.
-
-    \param annotation The annotation to process.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
-   */
-   QLabel *createDateLabel(const Annotation &annotation, bool isFirst);
-   /*!
-    \brief Factory method that creates a label with the author information based on an annotation.
-
-    \param author The author to be shown.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
-   */
-   QLabel *createAuthorLabel(const QString &author, bool isFirst);
-   /*!
-    \brief Factory method that creates a Clickable frame with the information of the commit (SHA and title).
-
-    \param sha The sha to show.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return Returns a newly created ButtonLink.
-   */
-   ButtonLink *createMessageLabel(const QString &sha, bool isFirst);
-   /*!
-    \brief Factory method that creates a label with the number of line. Uses the \p annotation parameter to display a
-    visual help about when the change was done.
-
-    \param annotation The annotation to process.
-    \param row The row to display.
-    \return QLabel Returns a newly created QLabel.
    */
-   QLabel *createNumLabel(const Annotation &annotation, int row);
+   void processBlame(const QString &blame);
    /*!
-    \brief Factory method that creates a label with the code line to be displayed.
+    \brief Formats the time since a change was done.
 
-    \param content The code line to display.
-    \return QLabel Returns a newly created QLable.
+    \param dateTime The date and time of the change.
+    \return QString The text to show.
    */
-   QLabel *createCodeLabel(const QString &content);
+   QString formatWhen(const QDateTime &dateTime) const;
 };
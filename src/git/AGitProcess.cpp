@@ -1,15 +1,25 @@
 #include "AGitProcess.h"
 
 #include <GitQlientSettings.h>
+
+#include <QMutex>
 #include <QTemporaryFile>
 #include <QTextStream>
 
 #include <QLogger.h>
 
+#include <atomic>
+#include <optional>
+
 using namespace QLogger;
 
 namespace
 {
+QMutex setupMutex;
+std::optional<QStringList> environment;
+std::optional<QString> gitLocation;
+std::atomic<quint64> spawnedCount { 0 };
+
 QString loginApp()
 {
    const auto askPassApp = qEnvironmentVariable("SSH_ASKPASS");
@@ -113,6 +123,32 @@ QStringList splitArgList(const QString &cmd)
    }
    return sl;
 }
+
+QStringList gitEnvironment()
+{
+   // Copying the system environment is expensive and it doesn't change during the session.
+   QMutexLocker lock(&setupMutex);
+
+   if (!environment)
+   {
+      environment = QProcess::systemEnvironment();
+      environment.value() << "GIT_TRACE=0"; // avoid choking on debug traces
+      environment.value() << "GIT_FLUSH=0"; // skip the fflush() in 'git log'
+      environment.value() << loginApp();
+   }
+
+   return environment.value();
+}
+
+QString gitProgram()
+{
+   QMutexLocker lock(&setupMutex);
+
+   if (!gitLocation)
+      gitLocation = GitQlientSettings().globalValue("gitLocation", "").toString();
+
+   return gitLocation->isEmpty() ? QString("git") : gitLocation.value();
+}
 }
 
 AGitProcess::AGitProcess(const QString &workingDir)
@@ -148,36 +184,62 @@ void AGitProcess::onReadyStandardOutput()
 
 bool AGitProcess::execute(const QString &command, const QStringList &commandArguments)
 {
-	mCommand = command;
+   mCommand = command;
+
+   QStringList arguments = commandArguments;
+
+   if (arguments.isEmpty())
+      arguments = splitArgList(mCommand);
+   else
+      arguments.prepend(command);
+
+   const auto processStarted = startGitProcess(this, arguments);
+
+   if (!processStarted)
+      QLog_Warning("Git", QString("Unable to start the process:\n%1\nMore info:\n%2").arg(mCommand, errorString()));
+   else
+   {
+      QLog_Debug("Git", QString("Process started: %1").arg(mCommand + commandArguments.join(" ")));
+
+      if (!mStandardInput.isNull())
+      {
+         write(mStandardInput);
+         closeWriteChannel();
+      }
+   }
+
+   return processStarted;
+}
+
+bool AGitProcess::startGitProcess(QProcess *process, QStringList arguments)
+{
+   if (arguments.isEmpty())
+      return false;
 
-	auto processStarted = false;
-	QStringList arguments = commandArguments;
+   const auto program = arguments.takeFirst();
 
-	if (arguments.isEmpty())
-		arguments = splitArgList(mCommand);
-	else
-		arguments.prepend(command);
+   process->setEnvironment(gitEnvironment());
+   process->setProgram(program == QString("git") ? gitProgram() : program);
+   process->setArguments(arguments);
+   process->start();
 
-	QStringList env = QProcess::systemEnvironment();
-	env << "GIT_TRACE=0"; // avoid choking on debug traces
-	env << "GIT_FLUSH=0"; // skip the fflush() in 'git log'
-	env << loginApp();
+   const auto spawned = ++spawnedCount;
 
-	const auto gitAlternative = GitQlientSettings().globalValue("gitLocation", "").toString();
+   QLog_Trace("Git", QString("Processes spawned so far: {%1}").arg(spawned));
 
-	setEnvironment(env);
-	setProgram(gitAlternative.isEmpty() ? arguments.takeFirst() : gitAlternative);
-	setArguments(arguments);
-	start();
+   return process->waitForStarted();
+}
 
-	processStarted = waitForStarted();
+quint64 AGitProcess::spawnedProcesses()
+{
+   return spawnedCount;
+}
 
-	if (!processStarted)
-		QLog_Warning("Git", QString("Unable to start the process:\n%1\nMore info:\n%2").arg(mCommand, errorString()));
-	else
-		QLog_Debug("Git", QString("Process started: %1").arg(mCommand + commandArguments.join(" ")));
+void AGitProcess::resetGitLocation()
+{
+   QMutexLocker lock(&setupMutex);
 
-	return processStarted;
+   gitLocation.reset();
 }
 
 void AGitProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
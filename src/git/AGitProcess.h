@@ -40,16 +40,42 @@ public:
    virtual GitExecResult run(const QString &command) = 0;
    void onCancel();
 
+   /**
+    * @brief startGitProcess Starts a process with the Git executable and the environment configured for GitQlient.
+    * @param process The process to start.
+    * @param arguments The command to run. If the program is git it's replaced by the one configured by the user.
+    * @return True if the process started, otherwise false.
+    */
+   static bool startGitProcess(QProcess *process, QStringList arguments);
+
+   /**
+    * @brief spawnedProcesses Gets the number of processes started since the application started.
+    * @return The number of processes.
+    */
+   static quint64 spawnedProcesses();
+
+   /**
+    * @brief resetGitLocation Discards the cached location of the Git executable so the next process reads it again
+    * from the settings.
+    */
+   static void resetGitLocation();
+
+   /**
+    * @brief setStandardInput Sets the data written to the standard input of Git once the process starts. It's used by
+    * the commands that read the revisions with --stdin instead of the command line.
+    * @param input The data to write.
+    */
+   void setStandardInput(const QByteArray &input) { mStandardInput = input; }
+
 protected:
    QString mRunOutput;
    QString mWorkingDirectory;
    QString mErrorOutput;
    QString mCommand;
+   QByteArray mStandardInput;
    bool mRealError = false;
    bool mCanceling = false;
-   bool execute(const QString &command);
+   bool execute(const QString &command, const QStringList &commandArguments = QStringList());
    virtual void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
-
-private:
-   void onReadyStandardOutput();
+   virtual void onReadyStandardOutput();
 };
@@ -12,11 +12,16 @@ HEADERS += \
     $$PWD/GitHistory.h \
     $$PWD/GitLocal.h \
     $$PWD/GitMerge.h \
+    $$PWD/GitNativeReader.h \
+    $$PWD/GitObjectResolver.h \
     $$PWD/GitPatches.h \
     $$PWD/GitRemote.h \
     $$PWD/GitRepoLoader.h \
+    $$PWD/GitRepoWatcher.h \
     $$PWD/GitRequestorProcess.h \
+    $$PWD/GitRevisionFilesReader.h \
     $$PWD/GitStashes.h \
+    $$PWD/GitStreamProcess.h \
     $$PWD/GitSubmodules.h \
     $$PWD/GitSubtree.h \
     $$PWD/GitSyncProcess.h \
@@ -35,11 +40,16 @@ SOURCES += \
     $$PWD/GitHistory.cpp \
     $$PWD/GitLocal.cpp \
     $$PWD/GitMerge.cpp \
+    $$PWD/GitNativeReader.cpp \
+    $$PWD/GitObjectResolver.cpp \
     $$PWD/GitPatches.cpp \
     $$PWD/GitRemote.cpp \
     $$PWD/GitRepoLoader.cpp \
+    $$PWD/GitRepoWatcher.cpp \
     $$PWD/GitRequestorProcess.cpp \
+    $$PWD/GitRevisionFilesReader.cpp \
     $$PWD/GitStashes.cpp \
+    $$PWD/GitStreamProcess.cpp \
     $$PWD/GitSubmodules.cpp \
     $$PWD/GitSubtree.cpp \
     $$PWD/GitSyncProcess.cpp \
@@ -1,6 +1,7 @@
 #include "GitBase.h"
 
 #include <GitAsyncProcess.h>
+#include <GitNativeReader.h>
 #include <GitSyncProcess.h>
 
 #include <QLogger.h>
@@ -9,12 +10,14 @@ using namespace QLogger;
 
 #include <QDir>
 #include <QFileInfo>
+#include <QThread>
 
-GitBase::GitBase(const QString &workingDirectory)
-   : mWorkingDirectory(workingDirectory)
-   , mGitDirectory(mWorkingDirectory + "/.git")
+namespace
 {
-   QFileInfo fileInfo(mGitDirectory);
+QString gitDirectoryOf(const QString &workingDirectory)
+{
+   const auto gitDirectory = workingDirectory + "/.git";
+   QFileInfo fileInfo(gitDirectory);
 
    if (fileInfo.isFile())
    {
@@ -22,13 +25,28 @@ GitBase::GitBase(const QString &workingDirectory)
 
       if (f.open(QIODevice::ReadOnly))
       {
-         auto path = f.readAll().split(':').last().trimmed();
-         mGitDirectory = mWorkingDirectory + "/" + path;
-         f.close();
+         // The path can be absolute (work trees) and contain colons (Windows drives).
+         const auto content = f.readAll().trimmed();
+         const auto path = QString::fromUtf8(content.mid(content.indexOf(':') + 1)).trimmed();
+
+         return QDir::isAbsolutePath(path) ? path : workingDirectory + "/" + path;
       }
    }
+
+   return gitDirectory;
+}
 }
 
+GitBase::GitBase(const QString &workingDirectory)
+   : mWorkingDirectory(workingDirectory)
+   , mGitDirectory(gitDirectoryOf(mWorkingDirectory))
+   , mOwnerThread(QThread::currentThread())
+   , mNativeReader(std::make_shared<GitNativeReader>(mGitDirectory))
+{
+}
+
+GitBase::~GitBase() = default;
+
 QString GitBase::getWorkingDir() const
 {
    return mWorkingDirectory;
@@ -36,7 +54,15 @@ QString GitBase::getWorkingDir() const
 
 void GitBase::setWorkingDir(const QString &workingDir)
 {
+   // The repository is reconfigured with every load. The helpers are only replaced when it really changes since other
+   // threads can be using them.
+   if (QDir::cleanPath(workingDir) == QDir::cleanPath(mWorkingDirectory))
+      return;
+
    mWorkingDirectory = workingDir;
+   mGitDirectory = gitDirectoryOf(mWorkingDirectory);
+   std::atomic_store(&mNativeReader, std::make_shared<GitNativeReader>(mGitDirectory));
+   std::atomic_store(&mResolver, std::shared_ptr<GitObjectResolver>());
 }
 
 QString GitBase::getGitDir() const
@@ -44,9 +70,10 @@ QString GitBase::getGitDir() const
    return mGitDirectory;
 }
 
-GitExecResult GitBase::run(const QString &cmd) const
+GitExecResult GitBase::run(const QString &cmd, const QByteArray &input) const
 {
    GitSyncProcess p(mWorkingDirectory);
+   p.setStandardInput(input);
 
    const auto ret = p.run(cmd);
    const auto runOutput = ret.output;
@@ -59,10 +86,29 @@ GitExecResult GitBase::run(const QString &cmd) const
    return ret;
 }
 
+std::optional<QByteArray> GitBase::runRaw(const QString &cmd, const QByteArray &input) const
+{
+   GitSyncProcess p(mWorkingDirectory);
+   p.setStandardInput(input);
+
+   const auto output = p.runRaw(cmd);
+
+   if (!output)
+      QLog_Warning("Git", QString("Git command {%1} has errors.").arg(cmd));
+
+   return output;
+}
+
 void GitBase::updateCurrentBranch()
 {
    QLog_Trace("Git", "Updating the cached current branch");
 
+   if (const auto branch = nativeReader()->currentBranch())
+   {
+      mCurrentBranch = branch.value();
+      return;
+   }
+
    const auto cmd = QString("git rev-parse --abbrev-ref HEAD");
 
    QLog_Trace("Git", QString("Updating the cached current branch: {%1}").arg(cmd));
@@ -88,7 +134,60 @@ GitExecResult GitBase::getLastCommit() const
 
    QLog_Trace("Git", QString("Getting last commit: {%1}").arg(cmd));
 
-   const auto ret = run(cmd);
+   const auto ret = resolveRevision("HEAD", cmd);
 
    return ret;
 }
+
+GitExecResult GitBase::resolveRevision(const QString &revision, const QString &fallbackCmd) const
+{
+   if (const auto sha = nativeReader()->resolve(revision))
+      return { true, sha.value() };
+
+   if (const auto objectResolver = resolver())
+   {
+      if (const auto objects = objectResolver->resolve({ revision }))
+      {
+         const auto sha = objects->constFirst().sha;
+
+         return { !sha.isEmpty(), sha };
+      }
+   }
+
+   return run(fallbackCmd);
+}
+
+std::optional<QVector<GitObjectResolver::Object>> GitBase::readObjects(const QStringList &revisions) const
+{
+   if (const auto objectResolver = resolver())
+      return objectResolver->read(revisions);
+
+   return std::nullopt;
+}
+
+std::shared_ptr<GitNativeReader> GitBase::nativeReader() const
+{
+   return std::atomic_load(&mNativeReader);
+}
+
+std::shared_ptr<GitObjectResolver> GitBase::resolver() const
+{
+   // The resolver is a QProcess, so it can only be used from the thread that owns it.
+   if (QThread::currentThread() != mOwnerThread || mWorkingDirectory.isEmpty())
+      return nullptr;
+
+   auto objectResolver = std::atomic_load(&mResolver);
+
+   if (!objectResolver)
+   {
+      objectResolver = std::make_shared<GitObjectResolver>(mWorkingDirectory);
+      std::atomic_store(&mResolver, objectResolver);
+   }
+
+   return objectResolver;
+}
+
+std::optional<QString> GitBase::readConfigValue(const QString &key) const
+{
+   return nativeReader()->configValue(key);
+}
@@ -24,13 +24,39 @@
  ***************************************************************************************/
 
 #include <GitExecResult.h>
+#include <GitObjectResolver.h>
+
+#include <QScopedPointer>
+
+#include <memory>
+#include <optional>
+
+class GitNativeReader;
+class QThread;
 
 class GitBase final
 {
 public:
    explicit GitBase(const QString &workingDirectory);
+   ~GitBase();
+
+   /**
+    * @brief run Runs a Git command and waits for it to finish. A command that takes longer than 10 s is stopped and
+    * fails.
+    * @param cmd The command to run.
+    * @param input The data written to the standard input, for the commands that read it with --stdin.
+    * @return The result of the command.
+    */
+   GitExecResult run(const QString &cmd, const QByteArray &input = QByteArray()) const;
 
-   GitExecResult run(const QString &cmd) const;
+   /**
+    * @brief runRaw Runs a Git command, waits for it to finish and returns its output without converting it to text.
+    * It's needed by the commands whose output has NUL separators (-z).
+    * @param cmd The command to run.
+    * @param input The data written to the standard input, for the commands that read it with --stdin.
+    * @return The standard output, or std::nullopt if the command failed.
+    */
+   std::optional<QByteArray> runRaw(const QString &cmd, const QByteArray &input = QByteArray()) const;
 
    QString getWorkingDir() const;
 
@@ -44,8 +70,41 @@ public:
 
    GitExecResult getLastCommit() const;
 
+   /**
+    * @brief resolveRevision Gets the SHA of the object a revision points to. It reads the Git directory directly when
+    * possible. Otherwise it uses the persistent object resolver when called from the thread that created this object,
+    * or runs @p fallbackCmd.
+    * @param revision The revision to resolve (SHA, reference, HEAD, tag^{commit}, etc.).
+    * @param fallbackCmd The Git command that returns the same SHA.
+    * @return The result with the SHA as output.
+    */
+   GitExecResult resolveRevision(const QString &revision, const QString &fallbackCmd) const;
+
+   /**
+    * @brief readObjects Reads the content of several objects at once through the persistent object reader. It can only
+    * be used from the thread that created this object.
+    * @param revisions The revisions of the objects to read.
+    * @return The objects in the same order as the @p revisions, or std::nullopt if they couldn't be read.
+    */
+   std::optional<QVector<GitObjectResolver::Object>> readObjects(const QStringList &revisions) const;
+
+   /**
+    * @brief readConfigValue Reads a configuration value directly from the configuration files.
+    * @param key The configuration key.
+    * @return The value (empty if it's not set) or std::nullopt if it must be read through Git.
+    */
+   std::optional<QString> readConfigValue(const QString &key) const;
+
 protected:
    QString mWorkingDirectory;
    QString mGitDirectory;
    QString mCurrentBranch;
+   QThread *mOwnerThread = nullptr;
+   // The helpers are replaced when the repository changes while other threads can be using them. They are only
+   // accessed with std::atomic_load and std::atomic_store, and used through the copy loaded.
+   std::shared_ptr<GitNativeReader> mNativeReader;
+   mutable std::shared_ptr<GitObjectResolver> mResolver;
+
+   std::shared_ptr<GitNativeReader> nativeReader() const;
+   std::shared_ptr<GitObjectResolver> resolver() const;
 };
@@ -177,7 +177,7 @@ GitExecResult GitBranches::getLastCommitOfBranch(const QString &branch)
 
    QLog_Trace("Git", QString("Getting last commit of a branch: {%1}").arg(cmd));
 
-   auto ret = mGitBase->run(cmd);
+   auto ret = mGitBase->resolveRevision(branch, cmd);
 
    if (ret.success)
       ret.output = ret.output.trimmed();
@@ -170,6 +170,9 @@ GitExecResult GitConfig::getGitValue(const QString &key) const
 {
    QLog_Debug("Git", QString("Getting value for config key {%1}").arg(key));
 
+   if (const auto value = mGitBase->readConfigValue(key))
+      return { true, value.value() };
+
    const auto ret = mGitBase->run(QString("git config --get %1").arg(key));
 
    return ret;
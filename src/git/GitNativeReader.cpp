@@ -0,0 +1,510 @@
+#include "GitNativeReader.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+static const char *COMMIT_SUFFIX("^{commit}");
+static const auto SHA_LENGTH = 40;
+static const auto MAX_DEPTH = 5;
+static const auto MAX_LOOSE_OBJECT_SIZE = 64 * 1024;
+
+namespace
+{
+bool isSha(const QString &text)
+{
+   return text.length() == SHA_LENGTH && std::all_of(text.cbegin(), text.cend(), [](QChar c) {
+             return (c >= QChar('0') && c <= QChar('9')) || (c >= QChar('a') && c <= QChar('f'));
+          });
+}
+
+bool isPseudoReference(const QString &name)
+{
+   return std::all_of(name.cbegin(), name.cend(), [](QChar c) { return c == QChar('_') || c.isUpper(); });
+}
+
+bool isSafeReferenceName(const QString &name)
+{
+   // Anything that looks like a revision expression or could escape from the Git directory is left to Git.
+   static const QString forbidden("^~:?*[\\ @{}");
+
+   if (name.isEmpty() || name.startsWith('/') || name.startsWith('-') || name.endsWith('/')
+       || name.endsWith(QString(".lock")) || name.contains(QString("..")) || name.contains(QString("//")))
+   {
+      return false;
+   }
+
+   return std::none_of(name.cbegin(), name.cend(),
+                       [](QChar c) { return c.unicode() < 0x20 || forbidden.contains(c); });
+}
+
+QByteArray readSmallFile(const QString &path)
+{
+   QFile file(path);
+
+   return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+/**
+ * @brief Parses a configuration value starting at @p pos until the end of the line, handling quotes, escape sequences,
+ * comments and line continuations the same way Git does.
+ */
+bool parseConfigValue(const QString &text, int &pos, QString &value)
+{
+   const auto length = text.length();
+   auto quoted = false;
+   QString pendingSpaces;
+
+   while (pos < length && (text[pos] == QChar(' ') || text[pos] == QChar('\t')))
+      ++pos;
+
+   for (; pos < length; ++pos)
+   {
+      const auto c = text[pos];
+
+      if (c == QChar('\n'))
+         break;
+      else if (c == QChar('\r'))
+         continue;
+      else if (!quoted && (c == QChar('#') || c == QChar(';')))
+      {
+         while (pos < length && text[pos] != QChar('\n'))
+            ++pos;
+
+         break;
+      }
+      else if (!quoted && (c == QChar(' ') || c == QChar('\t')))
+      {
+         pendingSpaces.append(c);
+         continue;
+      }
+
+      // The spaces at the beginning and at the end of the value are dropped, the ones in the middle are kept.
+      if (!value.isEmpty())
+         value.append(pendingSpaces);
+
+      pendingSpaces.clear();
+
+      if (c == QChar('"'))
+         quoted = !quoted;
+      else if (c == QChar('\\'))
+      {
+         if (++pos == length)
+            return false;
+
+         switch (text[pos].unicode())
+         {
+            case '\r':
+               if (pos + 1 < length && text[pos + 1] == QChar('\n'))
+                  ++pos;
+               break;
+            case '\n':
+               break;
+            case 'n':
+               value.append(QChar('\n'));
+               break;
+            case 't':
+               value.append(QChar('\t'));
+               break;
+            case 'b':
+               value.append(QChar('\b'));
+               break;
+            case '"':
+            case '\\':
+               value.append(text[pos]);
+               break;
+            default:
+               return false;
+         }
+      }
+      else
+         value.append(c);
+   }
+
+   return !quoted;
+}
+
+/**
+ * @brief Parses a configuration file. The keys are normalized as Git does: the section and the name are case
+ * insensitive and the subsection is not.
+ *
+ * @return False if the file can't be parsed or it includes other files.
+ */
+bool parseConfig(const QString &text, QHash<QString, QString> &values)
+{
+   const auto length = text.length();
+   auto pos = 0;
+   QString section;
+
+   while (pos < length)
+   {
+      const auto c = text[pos];
+
+      if (c.isSpace())
+      {
+         ++pos;
+         continue;
+      }
+
+      if (c == QChar('#') || c == QChar(';'))
+      {
+         while (pos < length && text[pos] != QChar('\n'))
+            ++pos;
+
+         continue;
+      }
+
+      if (c == QChar('['))
+      {
+         ++pos;
+         section.clear();
+
+         while (pos < length && text[pos] != QChar(']') && text[pos] != QChar('"') && !text[pos].isSpace())
+            section.append(text[pos++].toLower());
+
+         while (pos < length && (text[pos] == QChar(' ') || text[pos] == QChar('\t')))
+            ++pos;
+
+         if (pos < length && text[pos] == QChar('"'))
+         {
+            section.append(QChar('.'));
+
+            for (++pos; pos < length && text[pos] != QChar('"'); ++pos)
+            {
+               if (text[pos] == QChar('\\') && pos + 1 < length)
+                  ++pos;
+
+               section.append(text[pos]);
+            }
+
+            ++pos;
+         }
+
+         if (pos >= length || text[pos] != QChar(']') || section.isEmpty())
+            return false;
+
+         ++pos;
+
+         // The included files would need to be parsed as well, including the conditions of includeIf.
+         if (section == QString("include") || section.startsWith(QString("includeif.")))
+            return false;
+
+         continue;
+      }
+
+      if (section.isEmpty() || !c.isLetter())
+         return false;
+
+      QString name;
+
+      while (pos < length && (text[pos].isLetterOrNumber() || text[pos] == QChar('-')))
+         name.append(text[pos++].toLower());
+
+      while (pos < length && (text[pos] == QChar(' ') || text[pos] == QChar('\t') || text[pos] == QChar('\r')))
+         ++pos;
+
+      QString value;
+
+      if (pos < length && text[pos] == QChar('='))
+      {
+         ++pos;
+
+         if (!parseConfigValue(text, pos, value))
+            return false;
+      }
+      else if (pos < length && text[pos] != QChar('\n') && text[pos] != QChar('#') && text[pos] != QChar(';'))
+         return false;
+
+      values.insert(section + QChar('.') + name, value);
+   }
+
+   return true;
+}
+}
+
+GitNativeReader::GitNativeReader(const QString &gitDir)
+   : mGitDir(gitDir)
+   , mCommonDir(gitDir)
+{
+   // Linked work trees keep HEAD in their own directory but share the references and the configuration.
+   if (const auto commonDir = QString::fromUtf8(readSmallFile(mGitDir + QString("/commondir")).trimmed());
+       !commonDir.isEmpty())
+   {
+      mCommonDir = QDir::cleanPath(QDir(mGitDir).absoluteFilePath(commonDir));
+   }
+}
+
+std::optional<QString> GitNativeReader::resolve(const QString &revision) const
+{
+   auto name = revision;
+   const auto peel = name.endsWith(QString::fromUtf8(COMMIT_SUFFIX));
+
+   if (peel)
+      name.chop(static_cast<int>(strlen(COMMIT_SUFFIX)));
+
+   std::optional<Reference> reference;
+
+   if (isSha(name))
+      reference = Reference { name, std::nullopt };
+   else if (isSafeReferenceName(name))
+      reference = resolveShortName(name);
+
+   if (!reference)
+      return std::nullopt;
+
+   return peel ? peelToCommit(reference.value()) : reference->sha;
+}
+
+std::optional<QString> GitNativeReader::currentBranch() const
+{
+   const auto head = readSmallFile(mGitDir + QString("/HEAD")).trimmed();
+
+   if (!head.startsWith("ref:"))
+      return isSha(QString::fromLatin1(head)) ? std::optional<QString>(QString("HEAD")) : std::nullopt;
+
+   const auto target = QString::fromUtf8(head.mid(4)).trimmed();
+
+   // A branch without commits is left to Git so it reports it the same way it always did.
+   if (!target.startsWith(QString("refs/heads/")) || !isSafeReferenceName(target) || !readReference(target))
+      return std::nullopt;
+
+   return target.mid(11);
+}
+
+std::optional<QString> GitNativeReader::configValue(const QString &key) const
+{
+   // The configuration can be overridden from the environment.
+   for (const auto variable : { "GIT_CONFIG", "GIT_CONFIG_GLOBAL", "GIT_CONFIG_SYSTEM", "GIT_CONFIG_NOSYSTEM",
+                                "GIT_CONFIG_COUNT", "GIT_CONFIG_PARAMETERS" })
+   {
+      if (qEnvironmentVariableIsSet(variable))
+         return std::nullopt;
+   }
+
+   const auto firstDot = key.indexOf('.');
+   const auto lastDot = key.lastIndexOf('.');
+
+   if (firstDot <= 0 || lastDot == key.length() - 1)
+      return std::nullopt;
+
+   const auto normalizedKey = key.left(firstDot).toLower() + key.mid(firstDot, lastDot - firstDot) + QChar('.')
+       + key.mid(lastDot + 1).toLower();
+
+   const auto files = configFiles();
+
+   if (files.isEmpty())
+      return std::nullopt;
+
+   QMutexLocker lock(&mMutex);
+
+   QString value;
+
+   for (const auto &path : files)
+   {
+      const auto file = readConfigFile(path);
+
+      if (!file)
+         continue;
+
+      if (file->unsupported)
+         return std::nullopt;
+
+      if (const auto iter = file->values.constFind(normalizedKey); iter != file->values.constEnd())
+         value = iter.value();
+   }
+
+   return value;
+}
+
+GitNativeReader::Stamp GitNativeReader::stampOf(const QString &path)
+{
+   const QFileInfo info(path);
+
+   if (!info.exists())
+      return Stamp();
+
+   return { info.lastModified().toMSecsSinceEpoch(), info.size() };
+}
+
+std::optional<GitNativeReader::Reference> GitNativeReader::readReference(const QString &name, int depth) const
+{
+   if (depth > MAX_DEPTH)
+      return std::nullopt;
+
+   // HEAD and the other pseudo references belong to the work tree. The rest are shared by all of them.
+   const auto isSharedReference = name.startsWith(QString("refs/"));
+   const auto content = readSmallFile((isSharedReference ? mCommonDir : mGitDir) + QChar('/') + name).trimmed();
+
+   if (content.startsWith("ref:"))
+   {
+      const auto target = QString::fromUtf8(content.mid(4)).trimmed();
+
+      return isSafeReferenceName(target) ? readReference(target, depth + 1) : std::nullopt;
+   }
+
+   if (!content.isEmpty())
+   {
+      const auto sha = QString::fromLatin1(content.left(SHA_LENGTH));
+
+      return isSha(sha) ? std::optional<Reference>(Reference { sha, std::nullopt }) : std::nullopt;
+   }
+
+   return isSharedReference ? readPackedReference(name) : std::nullopt;
+}
+
+std::optional<GitNativeReader::Reference> GitNativeReader::readPackedReference(const QString &name) const
+{
+   const auto path = mCommonDir + QString("/packed-refs");
+   const auto stamp = stampOf(path);
+
+   QMutexLocker lock(&mMutex);
+
+   if (!(stamp == mPackedRefs.stamp))
+   {
+      mPackedRefs = PackedRefs();
+      mPackedRefs.stamp = stamp;
+
+      const auto data = readSmallFile(path);
+      const auto lines = data.split('\n');
+      QString lastReference;
+
+      for (const auto &line : lines)
+      {
+         if (line.startsWith('#'))
+            mPackedRefs.fullyPeeled = line.contains(" fully-peeled");
+         else if (line.startsWith('^') && !lastReference.isEmpty())
+            mPackedRefs.refs[lastReference].peeled = QString::fromLatin1(line.mid(1, SHA_LENGTH));
+         else if (line.length() > SHA_LENGTH + 1 && line.at(SHA_LENGTH) == ' ')
+         {
+            lastReference = QString::fromUtf8(line.mid(SHA_LENGTH + 1)).trimmed();
+            mPackedRefs.refs.insert(lastReference, { QString::fromLatin1(line.left(SHA_LENGTH)), QString() });
+         }
+      }
+   }
+
+   const auto iter = mPackedRefs.refs.constFind(name);
+
+   if (iter == mPackedRefs.refs.constEnd())
+      return std::nullopt;
+
+   Reference reference { iter->sha, std::nullopt };
+
+   // When the file is fully peeled, the references without a peeled line are not annotated tags.
+   if (!iter->peeled.isEmpty())
+      reference.peeled = iter->peeled;
+   else if (mPackedRefs.fullyPeeled)
+      reference.peeled = iter->sha;
+
+   return reference;
+}
+
+std::optional<GitNativeReader::Reference> GitNativeReader::resolveShortName(const QString &name) const
+{
+   // Same rules Git follows to disambiguate a name.
+   if (name.startsWith(QString("refs/")) || isPseudoReference(name))
+   {
+      if (const auto reference = readReference(name))
+         return reference;
+   }
+
+   for (const auto &format : { "refs/%1", "refs/tags/%1", "refs/heads/%1", "refs/remotes/%1", "refs/remotes/%1/HEAD" })
+   {
+      if (const auto reference = readReference(QString::fromUtf8(format).arg(name)))
+         return reference;
+   }
+
+   return std::nullopt;
+}
+
+std::optional<QString> GitNativeReader::peelToCommit(const Reference &reference) const
+{
+   if (reference.peeled)
+      return reference.peeled;
+
+   // Without peeled information the type of the object is read. Only the loose objects are supported.
+   auto sha = reference.sha;
+
+   for (auto depth = 0; depth < MAX_DEPTH; ++depth)
+   {
+      QFile file(mCommonDir + QString("/objects/%1/%2").arg(sha.left(2), sha.mid(2)));
+
+      if (file.size() > MAX_LOOSE_OBJECT_SIZE || !file.open(QIODevice::ReadOnly))
+         return std::nullopt;
+
+      // qUncompress needs the expected size in front of the zlib stream. It grows the buffer if it's not enough.
+      QByteArray compressed(4, '\0');
+      qToBigEndian<quint32>(static_cast<quint32>(file.size() * 4), compressed.data());
+      compressed.append(file.readAll());
+
+      const auto object = qUncompress(compressed);
+
+      if (object.startsWith("commit "))
+         return sha;
+
+      if (!object.startsWith("tag "))
+         return std::nullopt;
+
+      const auto objectPos = object.indexOf(QByteArray("\0object ", 8));
+
+      if (objectPos == -1)
+         return std::nullopt;
+
+      sha = QString::fromLatin1(object.mid(objectPos + 8, SHA_LENGTH));
+
+      if (!isSha(sha))
+         return std::nullopt;
+   }
+
+   return std::nullopt;
+}
+
+const GitNativeReader::ConfigFile *GitNativeReader::readConfigFile(const QString &path) const
+{
+   const auto stamp = stampOf(path);
+
+   if (stamp.modified == -1)
+      return nullptr;
+
+   auto &file = mConfigFiles[path];
+
+   if (!(file.stamp == stamp))
+   {
+      file = ConfigFile();
+      file.stamp = stamp;
+      file.unsupported = !parseConfig(QString::fromUtf8(readSmallFile(path)), file.values);
+
+      // The per work tree configuration would need to be read as well.
+      if (file.values.value(QString("extensions.worktreeconfig")).compare(QString("true"), Qt::CaseInsensitive) == 0)
+         file.unsupported = true;
+   }
+
+   return &file;
+}
+
+QVector<QString> GitNativeReader::configFiles() const
+{
+   QVector<QString> files;
+
+   // Without the configuration of the repository, Git could be reading it from somewhere else.
+   if (mGitDir.isEmpty() || !QFileInfo(mCommonDir + QString("/config")).isFile())
+      return files;
+
+#ifdef Q_OS_LINUX
+   // The location of the system configuration depends on how Git was built. Only the standard one on Linux is known.
+   const auto home = QDir::homePath();
+   const auto xdgConfig = qEnvironmentVariable("XDG_CONFIG_HOME");
+
+   files.append(QString("/etc/gitconfig"));
+   files.append((xdgConfig.isEmpty() ? home + QString("/.config") : xdgConfig) + QString("/git/config"));
+   files.append(home + QString("/.gitconfig"));
+   files.append(mCommonDir + QString("/config"));
+#endif
+
+   return files;
+}
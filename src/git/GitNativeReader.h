@@ -0,0 +1,124 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <optional>
+
+/**
+ * @brief The GitNativeReader class answers the most frequent questions about a repository (what HEAD points to, the
+ * SHA of a reference or a tag and the configuration values) by reading the files of the Git directory directly instead
+ * of starting a Git process.
+ *
+ * It only understands the common cases: loose references, packed-refs, loose objects and plain configuration files.
+ * Whenever it finds something it can't answer with certainty (a packed object, an included configuration file, a
+ * revision expression, etc.) it returns std::nullopt and the caller falls back to the Git command line.
+ *
+ * All the methods are thread-safe.
+ */
+class GitNativeReader final
+{
+public:
+   /**
+    * @brief Default constructor.
+    * @param gitDir The Git directory of the repository. For linked work trees, the one of the work tree.
+    */
+   explicit GitNativeReader(const QString &gitDir);
+
+   /**
+    * @brief resolve Gets the SHA a revision points to. The revision can be HEAD, a full or short reference name, a
+    * full SHA or any of them followed by ^{commit}.
+    * @param revision The revision to resolve.
+    * @return The SHA or std::nullopt if the revision can't be resolved natively.
+    */
+   std::optional<QString> resolve(const QString &revision) const;
+
+   /**
+    * @brief currentBranch Gets the name of the branch HEAD points to, or "HEAD" when it's detached.
+    * @return The name of the branch or std::nullopt if it can't be read natively.
+    */
+   std::optional<QString> currentBranch() const;
+
+   /**
+    * @brief configValue Gets the value of a configuration key following the same precedence Git does (system, global
+    * and local).
+    * @param key The key in the section.[subsection.]name form.
+    * @return The value (empty if the key is not set) or std::nullopt if the configuration can't be read natively. That
+    * includes the repositories without a configuration file.
+    */
+   std::optional<QString> configValue(const QString &key) const;
+
+private:
+   struct Stamp
+   {
+      qint64 modified = -1;
+      qint64 size = -1;
+
+      bool operator==(const Stamp &other) const { return modified == other.modified && size == other.size; }
+   };
+
+   struct PackedRef
+   {
+      QString sha;
+      QString peeled;
+   };
+
+   struct PackedRefs
+   {
+      Stamp stamp;
+      bool fullyPeeled = false;
+      QHash<QString, PackedRef> refs;
+   };
+
+   struct ConfigFile
+   {
+      Stamp stamp;
+      bool unsupported = false;
+      QHash<QString, QString> values;
+   };
+
+   struct Reference
+   {
+      QString sha;
+      std::optional<QString> peeled;
+   };
+
+   QString mGitDir;
+   QString mCommonDir;
+   mutable QMutex mMutex;
+   mutable PackedRefs mPackedRefs;
+   mutable QHash<QString, ConfigFile> mConfigFiles;
+
+   static Stamp stampOf(const QString &path);
+   std::optional<Reference> readReference(const QString &name, int depth = 0) const;
+   std::optional<Reference> readPackedReference(const QString &name) const;
+   std::optional<Reference> resolveShortName(const QString &name) const;
+   std::optional<QString> peelToCommit(const Reference &reference) const;
+   const ConfigFile *readConfigFile(const QString &path) const;
+   QVector<QString> configFiles() const;
+};
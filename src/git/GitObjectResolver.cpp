@@ -0,0 +1,167 @@
+#include "GitObjectResolver.h"
+
+#include <AGitProcess.h>
+
+#include <QLogger.h>
+
+#include <QProcess>
+#include <QStringList>
+
+using namespace QLogger;
+
+static const auto RESPONSE_TIMEOUT_MS = 5000;
+static const auto MAX_FAILED_STARTS = 3;
+
+GitObjectResolver::GitObjectResolver(const QString &workingDir)
+   : mWorkingDir(workingDir)
+{
+   mChecker.mode = QString("--batch-check");
+   mReader.mode = QString("--batch");
+}
+
+GitObjectResolver::~GitObjectResolver()
+{
+   reset(mChecker);
+   reset(mReader);
+}
+
+std::optional<QVector<GitObjectResolver::Object>> GitObjectResolver::resolve(const QStringList &names)
+{
+   return request(mChecker, names);
+}
+
+std::optional<QVector<GitObjectResolver::Object>> GitObjectResolver::read(const QStringList &names)
+{
+   return request(mReader, names);
+}
+
+std::optional<QVector<GitObjectResolver::Object>> GitObjectResolver::request(Helper &helper, const QStringList &names)
+{
+   QByteArray request;
+
+   for (const auto &name : names)
+   {
+      // Each request is a line, so a name can't contain a line break.
+      if (name.isEmpty() || name.contains('\n'))
+         return std::nullopt;
+
+      request.append(name.toUtf8());
+      request.append('\n');
+   }
+
+   if (!ensureStarted(helper))
+      return std::nullopt;
+
+   helper.process->write(request);
+
+   QVector<Object> objects;
+   objects.reserve(names.count());
+
+   QByteArray line;
+
+   for (auto i = 0; i < names.count(); ++i)
+   {
+      if (!readLine(helper, line))
+      {
+         QLog_Warning("Git", "The object resolver stopped answering. It will be restarted.");
+         reset(helper);
+         return std::nullopt;
+      }
+
+      // The answer is "<sha> <type> <size>" or "<name> missing" (also "ambiguous" for short SHAs). When reading, the
+      // content and a line break follow the objects found.
+      Object object;
+
+      if (const auto fields = line.split(' '); fields.count() == 3)
+      {
+         object.sha = QString::fromLatin1(fields.at(0));
+         object.type = QString::fromLatin1(fields.at(1));
+         object.size = fields.at(2).toLongLong();
+
+         if (&helper == &mReader && !readContent(helper, object.size, object.content))
+         {
+            QLog_Warning("Git", "The object reader stopped answering. It will be restarted.");
+            reset(helper);
+            return std::nullopt;
+         }
+      }
+
+      objects.append(std::move(object));
+   }
+
+   return objects;
+}
+
+bool GitObjectResolver::ensureStarted(Helper &helper)
+{
+   if (helper.process && helper.process->state() == QProcess::Running)
+      return true;
+
+   reset(helper);
+
+   if (helper.failedStarts >= MAX_FAILED_STARTS)
+      return false;
+
+   helper.process.reset(new QProcess());
+   helper.process->setWorkingDirectory(mWorkingDir);
+   helper.process->setStandardErrorFile(QProcess::nullDevice());
+
+   if (!AGitProcess::startGitProcess(helper.process.data(), { "git", "cat-file", helper.mode }))
+   {
+      QLog_Warning("Git", QString("Unable to start the object resolver: %1").arg(helper.process->errorString()));
+
+      ++helper.failedStarts;
+      reset(helper);
+
+      return false;
+   }
+
+   QLog_Debug("Git", QString("Object resolver {%1} started for {%2}.").arg(helper.mode, mWorkingDir));
+
+   helper.failedStarts = 0;
+
+   return true;
+}
+
+bool GitObjectResolver::readLine(Helper &helper, QByteArray &line)
+{
+   while (!helper.process->canReadLine())
+   {
+      if (!helper.process->waitForReadyRead(RESPONSE_TIMEOUT_MS))
+         return false;
+   }
+
+   line = helper.process->readLine();
+   line.chop(1);
+
+   return true;
+}
+
+bool GitObjectResolver::readContent(Helper &helper, qint64 size, QByteArray &content)
+{
+   // The content is followed by a line break that is not part of it.
+   while (helper.process->bytesAvailable() < size + 1)
+   {
+      if (!helper.process->waitForReadyRead(RESPONSE_TIMEOUT_MS))
+         return false;
+   }
+
+   content = helper.process->read(size);
+   helper.process->read(1);
+
+   return true;
+}
+
+void GitObjectResolver::reset(Helper &helper)
+{
+   if (helper.process)
+   {
+      // Closing the input makes cat-file finish by itself.
+      helper.process->closeWriteChannel();
+
+      if (!helper.process->waitForFinished(100))
+         helper.process->kill();
+
+      helper.process.reset();
+   }
+}
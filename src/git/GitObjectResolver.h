@@ -0,0 +1,100 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+
+#include <optional>
+
+class QProcess;
+class QStringList;
+
+/**
+ * @brief The GitObjectResolver class keeps two Git processes alive to work with objects without starting a new Git
+ * process for each of them: `git cat-file --batch-check` resolves revisions (SHAs, references, HEAD, tag^{commit},
+ * etc.) and `git cat-file --batch` reads their content. Each one is started on its first request.
+ *
+ * The requests are pipelined: all the names are written at once and the answers are read in the same order. The
+ * answers are read synchronously because the callers need them to continue. Git answers as soon as it reads the name,
+ * so a process that doesn't answer in a few seconds is considered stuck and restarted.
+ *
+ * Like any QProcess, an instance must only be used from the thread that created it.
+ */
+class GitObjectResolver final
+{
+public:
+   /**
+    * @brief The Object struct contains the information Git gives about an object.
+    */
+   struct Object
+   {
+      QString sha;
+      QString type;
+      qint64 size = 0;
+      QByteArray content;
+   };
+
+   explicit GitObjectResolver(const QString &workingDir);
+   ~GitObjectResolver();
+
+   /**
+    * @brief resolve Resolves a list of names in a single round trip to the helper process.
+    * @param names The names to resolve.
+    * @return The objects in the same order as the @p names, without content. The objects that don't exist have an empty
+    * SHA. If the helper process couldn't answer, std::nullopt.
+    */
+   std::optional<QVector<Object>> resolve(const QStringList &names);
+
+   /**
+    * @brief read Reads the content of a list of objects in a single round trip to the helper process.
+    * @param names The names of the objects.
+    * @return The objects in the same order as the @p names. The objects that don't exist have an empty SHA. If the
+    * helper process couldn't answer, std::nullopt.
+    */
+   std::optional<QVector<Object>> read(const QStringList &names);
+
+private:
+   /**
+    * @brief The Helper struct is one of the cat-file processes.
+    */
+   struct Helper
+   {
+      QString mode;
+      QScopedPointer<QProcess> process;
+      int failedStarts = 0;
+   };
+
+   QString mWorkingDir;
+   Helper mChecker;
+   Helper mReader;
+
+   std::optional<QVector<Object>> request(Helper &helper, const QStringList &names);
+   bool ensureStarted(Helper &helper);
+   bool readLine(Helper &helper, QByteArray &line);
+   bool readContent(Helper &helper, qint64 size, QByteArray &content);
+   void reset(Helper &helper);
+};
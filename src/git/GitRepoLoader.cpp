@@ -7,16 +7,49 @@
 #include <GitLocal.h>
 #include <GitQlientSettings.h>
 #include <GitRequestorProcess.h>
+#include <GitRevisionFilesReader.h>
+#include <GitStreamProcess.h>
 #include <GitTags.h>
 #include <GitWip.h>
+#include <HistorySnapshot.h>
 
 #include <QLogger.h>
 
 #include <QDir>
+#include <QFile>
+#include <QSet>
+
+#include <cstring>
+#include <string_view>
 
 using namespace QLogger;
 
 static const char *GIT_LOG_FORMAT("%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n%b ");
+static const auto BATCH_INTERVAL_MS = 150;
+static const auto MAX_SNAPSHOT_SEGMENTS = 32;
+static const char CHANGED_PATHS_COMMIT_MARK = '\001';
+
+namespace
+{
+/**
+ * @brief Walks the '\0' separated records of a raw log between @p begin and @p end without copying them.
+ */
+template<typename Callback>
+void forEachLogRecord(const char *begin, const char *end, Callback callback)
+{
+   while (begin < end)
+   {
+      auto recordEnd = static_cast<const char *>(memchr(begin, '\000', static_cast<size_t>(end - begin)));
+
+      if (!recordEnd)
+         recordEnd = end;
+
+      callback(std::string_view(begin, static_cast<size_t>(recordEnd - begin)));
+
+      begin = recordEnd + 1;
+   }
+}
+}
 
 GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<GitCache> cache,
                              const QSharedPointer<GitQlientSettings> &settings, QObject *parent)
@@ -26,6 +59,8 @@ GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<Git
    , mSettings(settings)
    , mGitTags(new GitTags(mGitBase, mRevCache))
 {
+   connect(mRevCache.get(), &GitCache::signalRevisionFilesPrefetchRequested, this,
+           &GitRepoLoader::prefetchRevisionFiles);
 }
 
 void GitRepoLoader::cancelAll()
@@ -121,6 +156,66 @@ void GitRepoLoader::loadAll()
    }
 }
 
+void GitRepoLoader::loadIncremental()
+{
+   if (mLocked)
+      QLog_Warning("Git", "Git is currently loading data.");
+   else
+   {
+      if (mGitBase->getWorkingDir().isEmpty())
+         QLog_Error("Git", "No working directory set.");
+      else if (!mRevCache->isInitialized() || mLogKey.isEmpty() || mLogKey != logKey() || isLogSigned())
+         loadAll();
+      else
+      {
+         mLocked = true;
+
+         mGitBase->updateCurrentBranch();
+
+         const auto parentSha = mGitBase->resolveRevision("HEAD", "git rev-parse --revs-only HEAD").output.trimmed();
+         mWipParentSha = parentSha.isEmpty() ? CommitInfo::INIT_SHA : parentSha;
+
+         const auto tips = readTips();
+
+         if (tips == mLogTips)
+         {
+            QLog_Debug("Git", "The references didn't change. Updating only the WIP.");
+
+            QScopedPointer<GitWip> git(new GitWip(mGitBase, mRevCache));
+            git->updateWip();
+
+            mLocked = false;
+
+            emit signalIncrementalLoadFinished(0, 0, false);
+         }
+         else if (const auto commits = requestNewCommits(mLogTips, tips); !commits)
+         {
+            QLog_Info("Git", "The history can't be updated incrementally. Reloading the whole repository.");
+
+            mLocked = false;
+
+            loadAll();
+         }
+         else
+         {
+            mNewCommits = mRevCache->insertCommits(commits.value(), mWipParentSha, mChangedRows);
+            mLogTips = tips;
+
+            QLog_Info("Git", QString("Added {%1} new commits to the history.").arg(mNewCommits));
+
+            QScopedPointer<GitWip> git(new GitWip(mGitBase, mRevCache));
+            git->updateWip();
+
+            mIncremental = true;
+            mRefreshReferences = true;
+            mSteps = 1;
+
+            requestReferences();
+         }
+      }
+   }
+}
+
 bool GitRepoLoader::configureRepoDirectory()
 {
    QLog_Debug("Git", "Configuring repository directory.");
@@ -153,62 +248,347 @@ void GitRepoLoader::requestReferences()
 
 void GitRepoLoader::processReferences(QByteArray ba)
 {
-   if (mRefreshReferences)
-      mRevCache->clearReferences();
+   static const QByteArray tagsPrefix("refs/tags/");
+   static const QByteArray peeledSuffix("^{}");
+   static const QByteArray headsPrefix("refs/heads/");
+   static const QByteArray remotesPrefix("refs/remotes/");
+   static const auto SHA_LENGTH = 40;
+
+   // All the references are handed to the cache at once, so it only applies the ones that changed since the last load.
+   QMap<References::Type, QHash<QString, QString>> references;
+   auto &tags = references[References::Type::LocalTag];
+   auto &localBranches = references[References::Type::LocalBranch];
+   auto &remoteBranches = references[References::Type::RemoteBranches];
+
+   for (auto lineStart = 0; lineStart < ba.size();)
+   {
+      auto lineEnd = ba.indexOf('\n', lineStart);
 
-   QString prevRefSha;
-   const auto referencesList = ba.split('\n');
+      if (lineEnd == -1)
+         lineEnd = ba.size();
 
-   for (const auto &reference : referencesList)
-   {
-      if (!reference.isEmpty())
-      {
-         auto revSha = QString::fromUtf8(reference.left(40));
-         const auto refName = reference.mid(41);
+      const auto line = QByteArray::fromRawData(ba.constData() + lineStart, lineEnd - lineStart);
+      lineStart = lineEnd + 1;
 
-         if (!refName.startsWith("refs/tags/") || (refName.startsWith("refs/tags/") && refName.endsWith("^{}")))
-         {
-            References::Type type;
-            QString name;
+      if (line.size() <= SHA_LENGTH + 1)
+         continue;
 
-            if (refName.startsWith("refs/tags/"))
-            {
-               type = References::Type::LocalTag;
-               name = QString::fromUtf8(refName.mid(10, reference.length()));
-               name.remove("^{}");
-            }
-            else if (refName.startsWith("refs/heads/"))
-            {
-               type = References::Type::LocalBranch;
-               name = QString::fromUtf8(refName.mid(11));
-            }
-            else if (refName.startsWith("refs/remotes/") && !refName.endsWith("HEAD"))
-            {
-               type = References::Type::RemoteBranches;
-               name = QString::fromUtf8(refName.mid(13));
-            }
-            else
-               continue;
+      const auto refName
+          = QByteArray::fromRawData(line.constData() + SHA_LENGTH + 1, line.size() - SHA_LENGTH - 1);
 
-            mRevCache->insertReference(revSha, type, name);
+      // Only the peeled entries of the tags point to the commits.
+      if (refName.startsWith(tagsPrefix))
+      {
+         if (refName.endsWith(peeledSuffix))
+         {
+            const auto nameLength = refName.size() - tagsPrefix.size() - peeledSuffix.size();
+            tags.insert(QString::fromUtf8(refName.constData() + tagsPrefix.size(), nameLength),
+                        QString::fromLatin1(line.constData(), SHA_LENGTH));
          }
-         prevRefSha = revSha;
+      }
+      else if (refName.startsWith(headsPrefix))
+      {
+         localBranches.insert(QString::fromUtf8(refName.constData() + headsPrefix.size(),
+                                                refName.size() - headsPrefix.size()),
+                              QString::fromLatin1(line.constData(), SHA_LENGTH));
+      }
+      else if (refName.startsWith(remotesPrefix) && !refName.endsWith("HEAD"))
+      {
+         remoteBranches.insert(QString::fromUtf8(refName.constData() + remotesPrefix.size(),
+                                                 refName.size() - remotesPrefix.size()),
+                               QString::fromLatin1(line.constData(), SHA_LENGTH));
       }
    }
 
-   mRevCache->reloadCurrentBranchInfo(mGitBase->getCurrentBranch(), mGitBase->getLastCommit().output.trimmed());
+   mRevCache->updateReferences(references, mGitBase->getCurrentBranch(),
+                               mGitBase->getLastCommit().output.trimmed());
+
+   onLoadStepFinished();
+}
 
+void GitRepoLoader::onLoadStepFinished()
+{
    --mSteps;
 
    if (mSteps == 0)
    {
+      const auto incremental = mIncremental;
+
       mRevCache->setConfigurationDone();
 
-      emit signalLoadingFinished(mRefreshReferences);
+      if (mIncremental)
+         emit signalIncrementalLoadFinished(mNewCommits, mChangedRows, true);
+      else
+         emit signalLoadingFinished(mRefreshReferences);
 
       mLocked = false;
       mRefreshReferences = false;
+      mIncremental = false;
+      mNewCommits = 0;
+      mChangedRows = 0;
+
+      requestLocalBranchDistances();
+
+      // The snapshot is written and the search index built once the UI has been notified so they don't delay the load.
+      // The incremental loads update the search index as the commits are inserted.
+      saveSnapshot();
+
+      if (!incremental)
+         mRevCache->buildSearchIndex();
+
+      requestChangedPaths();
+   }
+}
+
+void GitRepoLoader::prefetchRevisionFiles(const QString &sha)
+{
+   // The requests that arrive before the pending one is processed replace it: only the last selection matters.
+   mPendingPrefetch = sha;
+
+   if (!mPrefetchScheduled)
+   {
+      mPrefetchScheduled = true;
+      QMetaObject::invokeMethod(this, &GitRepoLoader::processPendingPrefetch, Qt::QueuedConnection);
+   }
+}
+
+void GitRepoLoader::processPendingPrefetch()
+{
+   mPrefetchScheduled = false;
+
+   // Only one request is read at a time. The selection that arrives meanwhile is processed when it finishes.
+   if (mPendingPrefetch.isEmpty() || mGitBase->getWorkingDir().isEmpty()
+       || (mRevisionFilesReader && mRevisionFilesReader->isBusy()))
+   {
+      return;
+   }
+
+   const auto revisions = mRevCache->revisionFilesToPrefetch(mPendingPrefetch);
+   mPendingPrefetch.clear();
+
+   if (revisions.isEmpty())
+      return;
+
+   if (!mRevisionFilesReader)
+   {
+      mRevisionFilesReader.reset(new GitRevisionFilesReader(mGitBase->getWorkingDir()));
+      connect(mRevisionFilesReader.get(), &GitRevisionFilesReader::revisionFilesRead, this,
+              &GitRepoLoader::onRevisionFilesRead);
+   }
+
+   mRevisionFilesReader->read(revisions);
+}
+
+void GitRepoLoader::onRevisionFilesRead(const QVector<QPair<QString, QString>> &revisions,
+                                        const QVector<QString> &outputs)
+{
+   if (outputs.count() == revisions.count())
+   {
+      for (auto i = 0; i < revisions.count(); ++i)
+      {
+         const auto &revision = revisions.at(i);
+         mRevCache->insertRevisionFiles(revision.first, revision.second, RevisionFiles(outputs.at(i)));
+      }
+
+      QLog_Trace("Git", QString("Prefetched the files of {%1} commits.").arg(revisions.count()));
+   }
+
+   processPendingPrefetch();
+}
+
+void GitRepoLoader::requestChangedPaths()
+{
+   // The paths changed by a commit never change: after any load only the commits that are not indexed yet are read.
+   // The log doesn't have the tips when it's limited or signed, so they are read here.
+   const auto tips = mLogTips.isEmpty() ? readTips() : mLogTips;
+
+   if (tips == mIndexedTips)
+      return;
+
+   // A new request discards the output of any previous one that didn't finish.
+   const auto request = mChangedPathsBuild.request + 1;
+   mChangedPathsBuild = ChangedPathsBuild();
+   mChangedPathsBuild.request = request;
+   mChangedPathsBuild.tips = tips;
+
+   auto indexedTips = mIndexedTips;
+
+   // The index saved in disk is the starting point when the repository is opened again.
+   if (indexedTips.isEmpty())
+   {
+      mChangedPathsBuild.replace = true;
+
+      if (mChangedPathsBuild.index.load(changedPathsPath(), indexedTips))
+         mSavedIndexTips = indexedTips;
+   }
+
+   // The revisions are written to the standard input of Git so the command line doesn't grow with the references.
+   QSet<QString> indexedShas;
+   QSet<QString> newShas;
+   QByteArray revisions;
+
+   for (const auto &sha : qAsConst(indexedTips))
+      indexedShas.insert(sha);
+
+   for (const auto &sha : tips)
+   {
+      if (!indexedShas.contains(sha) && !newShas.contains(sha))
+      {
+         newShas.insert(sha);
+         revisions.append(sha.toLatin1()).append('\n');
+      }
+   }
+
+   if (!indexedShas.isEmpty() && newShas.isEmpty())
+   {
+      processChangedPathsEnd(request, true);
+      return;
+   }
+
+   for (const auto &sha : qAsConst(indexedShas))
+      revisions.append('^').append(sha.toLatin1()).append('\n');
+
+   QLog_Debug("Git",
+              QString("Indexing the changed paths of {%1}.")
+                  .arg(indexedShas.isEmpty() ? "all the commits" : QString("%1 new tips").arg(newShas.count())));
+
+   const auto stream = new GitStreamProcess(mGitBase->getWorkingDir());
+   connect(stream, &GitStreamProcess::procDataReady, this,
+           [this, request](const QByteArray &chunk) { processChangedPathsChunk(request, chunk); });
+   connect(stream, &GitStreamProcess::signalStreamFinished, this,
+           [this, request](bool success) { processChangedPathsEnd(request, success); });
+   connect(this, &GitRepoLoader::cancelAllProcesses, stream, &AGitProcess::onCancel);
+
+   if (!indexedShas.isEmpty())
+      stream->setStandardInput(revisions);
+
+   stream->run(QString("git log %1 --no-color --name-status -z -M --format=%x01%H")
+                   .arg(indexedShas.isEmpty() ? "--all" : "--stdin"));
+}
+
+void GitRepoLoader::processChangedPathsChunk(int request, const QByteArray &chunk)
+{
+   if (request != mChangedPathsBuild.request)
+      return;
+
+   auto &buffer = mChangedPathsBuild.buffer;
+   buffer.append(chunk);
+
+   // Only the complete fields are processed. The last one stays in the buffer until its end arrives.
+   if (const auto end = buffer.lastIndexOf('\000'); end != -1)
+   {
+      forEachLogRecord(buffer.constData(), buffer.constData() + end,
+                       [this](std::string_view field) { processChangedPathsField(field); });
+
+      buffer.remove(0, end + 1);
+   }
+}
+
+void GitRepoLoader::processChangedPathsField(std::string_view field)
+{
+   auto &build = mChangedPathsBuild;
+
+   // Every commit starts with a mark and its SHA. The status of every file changed follows, then its path or, for the
+   // renames and copies, the paths before and after.
+   if (!field.empty() && field.front() == CHANGED_PATHS_COMMIT_MARK)
+   {
+      build.sha = QString::fromLatin1(field.data() + 1, static_cast<int>(field.size() - 1));
+      build.pendingPaths = 0;
+   }
+   else if (build.pendingPaths == 0)
+   {
+      // The first status of a commit comes after a line break.
+      while (!field.empty() && field.front() == '\n')
+         field.remove_prefix(1);
+
+      if (!field.empty())
+      {
+         build.rename = field.front() == 'R';
+         build.pendingPaths = field.front() == 'R' || field.front() == 'C' ? 2 : 1;
+      }
+   }
+   else
+   {
+      const auto path = QString::fromUtf8(field.data(), static_cast<int>(field.size()));
+
+      if (--build.pendingPaths == 1)
+         build.oldPath = path;
+      else if (build.oldPath.isEmpty())
+         build.index.insert(build.sha, path);
+      else
+      {
+         // The copies leave the source untouched: only the new file is changed.
+         if (build.rename)
+            build.index.insertRename(build.sha, build.oldPath, path);
+         else
+            build.index.insert(build.sha, path);
+
+         build.oldPath.clear();
+      }
+   }
+}
+
+void GitRepoLoader::processChangedPathsEnd(int request, bool success)
+{
+   if (request != mChangedPathsBuild.request)
+      return;
+
+   auto &build = mChangedPathsBuild;
+
+   if (!build.buffer.isEmpty())
+   {
+      forEachLogRecord(build.buffer.constData(), build.buffer.constData() + build.buffer.size(),
+                       [this](std::string_view field) { processChangedPathsField(field); });
+   }
+
+   if (success)
+   {
+      const auto index = mRevCache->updateChangedPaths(build.index, build.replace);
+      mIndexedTips = build.tips;
+
+      QLog_Info("Git", "The changed paths were indexed.");
+
+      if (mIndexedTips != mSavedIndexTips && index.save(changedPathsPath(), mIndexedTips))
+         mSavedIndexTips = mIndexedTips;
+   }
+   else
+   {
+      // An indexed tip might not exist anymore (after a garbage collection), so everything is read again.
+      QLog_Warning("Git", "The changed paths couldn't be read. They will be indexed again with the next load.");
+      mIndexedTips.clear();
+      mSavedIndexTips.clear();
+
+      QFile::remove(changedPathsPath());
+   }
+
+   mChangedPathsBuild = ChangedPathsBuild();
+   mChangedPathsBuild.request = request;
+}
+
+void GitRepoLoader::requestLocalBranchDistances()
+{
+   // Git only reports the upstreams: the distances are calculated with the history already loaded.
+   const auto ret = mGitBase->run("git for-each-ref --format=%(refname)%09%(upstream) refs/heads");
+
+   if (!ret.success)
+      return;
+
+   QHash<QString, QString> upstreams;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   const auto lines = ret.output.split('\n', Qt::SkipEmptyParts);
+#else
+   const auto lines = ret.output.split('\n', QString::SkipEmptyParts);
+#endif
+
+   for (const auto &line : lines)
+   {
+      const auto fields = line.split('\t');
+
+      if (fields.count() == 2 && !fields.constLast().isEmpty())
+         upstreams.insert(fields.constFirst().mid(QString("refs/heads/").length()), fields.constLast());
    }
+
+   mRevCache->updateLocalBranchDistances(upstreams);
 }
 
 void GitRepoLoader::requestRevisions()
@@ -219,35 +599,345 @@ void GitRepoLoader::requestRevisions()
    const auto commitsToRetrieve = maxCommits != 0 ? QString::fromUtf8("-n %1").arg(maxCommits)
                                                   : mShowAll ? QString("--all") : mGitBase->getCurrentBranch();
 
-   QString order;
+   mRevCache->setHistoryTruncated(maxCommits != 0);
+
+   const auto order = logOrder();
+
+   const auto baseCmd = QString("git log %1 --no-color --log-size --parents --boundary -z --pretty=format:%2 %3")
+                            .arg(order, QString::fromUtf8(GIT_LOG_FORMAT), commitsToRetrieve);
+
+   if (!mRevCache->isInitialized())
+      emit signalLoadingStarted();
 
+   if (isLogSigned())
+   {
+      mLogKey.clear();
+      mLogTips.clear();
+
+      // The GPG output is interleaved with the log and can't be split by records, so the signed log is still processed
+      // once Git finishes.
+      const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+      connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevisions);
+      connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+      requestor->run(baseCmd);
+   }
+   else
+   {
+      const auto parentSha = mGitBase->resolveRevision("HEAD", "git rev-parse --revs-only HEAD").output.trimmed();
+
+      mWipParentSha = parentSha.isEmpty() ? CommitInfo::INIT_SHA : parentSha;
+      mStreamStarted = false;
+      mLogBuffer.clear();
+
+      mLogKey = logKey();
+      mLogTips.clear();
+
+      if (!mLogKey.isEmpty())
+      {
+         mLogTips = readTips();
+
+         if (!mRevCache->isInitialized() && loadFromSnapshot())
+            return;
+      }
+
+      // The whole history is read again: the snapshot is written again too the next time it's saved.
+      mSnapshotCommits = -1;
+
+      const auto stream = new GitStreamProcess(mGitBase->getWorkingDir());
+      connect(stream, &GitStreamProcess::procDataReady, this, &GitRepoLoader::processRevisionsChunk);
+      connect(stream, &GitStreamProcess::signalStreamFinished, this, &GitRepoLoader::processRevisionsStreamEnd);
+      connect(this, &GitRepoLoader::cancelAllProcesses, stream, &AGitProcess::onCancel);
+
+      stream->run(baseCmd);
+   }
+}
+
+void GitRepoLoader::processRevisionsChunk(const QByteArray &chunk)
+{
+   mLogBuffer.append(chunk);
+
+   // Only the complete records are processed. The last one stays in the buffer until its end arrives.
+   if (const auto end = mLogBuffer.lastIndexOf('\000'); end != -1)
+      appendStreamedRecords(end);
+}
+
+void GitRepoLoader::appendStreamedRecords(int end)
+{
+   QVector<CommitInfo> commits;
+
+   forEachLogRecord(mLogBuffer.constData(), mLogBuffer.constData() + end, [&commits](std::string_view record) {
+      if (auto commit = CommitInfo { record }; commit.isValid())
+         commits.append(std::move(commit));
+   });
+
+   mLogBuffer.remove(0, qMin(end + 1, mLogBuffer.size()));
+
+   const auto firstBatch = !mStreamStarted;
+
+   if (firstBatch)
+   {
+      mStreamStarted = true;
+      mRevCache->startSetup(mWipParentSha);
+      mBatchTimer.start();
+   }
+
+   mRevCache->appendCommits(std::move(commits));
+
+   if (firstBatch || mBatchTimer.elapsed() >= BATCH_INTERVAL_MS)
+   {
+      mBatchTimer.restart();
+
+      emit signalRevisionsBatchLoaded(mRevCache->commitCount(), firstBatch);
+   }
+}
+
+void GitRepoLoader::processRevisionsStreamEnd(bool success)
+{
+   if (!success)
+      QLog_Warning("Git", "The log stream finished with errors. The history might be incomplete.");
+
+   if (!mLogBuffer.isEmpty())
+      appendStreamedRecords(mLogBuffer.size());
+   else if (!mStreamStarted)
+      mRevCache->startSetup(mWipParentSha);
+
+   mLogBuffer.clear();
+   mLogBuffer.squeeze();
+
+   QLog_Info("Git", QString("Revisions streamed: {%1} commits.").arg(mRevCache->commitCount() - 1));
+
+   mStreamStarted = false;
+
+   if (!success)
+      mLogTips.clear();
+
+   finishRevisions();
+}
+
+void GitRepoLoader::finishRevisions()
+{
+   QScopedPointer<GitWip> git(new GitWip(mGitBase, mRevCache));
+   const auto files = git->getUntrackedFiles();
+
+   mRevCache->setUntrackedFilesList(std::move(files));
+
+   if (const auto info = git->getWipInfo())
+      mRevCache->finishSetup(info->first, info->second);
+   else
+      mRevCache->finishSetup(mWipParentSha, RevisionFiles());
+
+   onLoadStepFinished();
+}
+
+void GitRepoLoader::saveSnapshot()
+{
+   if (!mLogKey.isEmpty() && !mLogTips.isEmpty() && mLogTips != mSavedTips)
+   {
+      // The commits are written from the pages of the published history: a copy only references them.
+      const auto state = mRevCache->renderState();
+      const auto &commits = state->commits;
+      const auto count = commits.count() - (commits.hasWip() ? 1 : 0);
+      const auto newCommits = count - mSnapshotCommits;
+
+      HistorySnapshot snapshot(snapshotPath());
+      auto saved = false;
+
+      // Only the commits added on top since the last time are appended. The file is written again when it doesn't
+      // match the history or it has too many segments.
+      if (mSnapshotCommits >= 0 && newCommits >= 0 && mSnapshotSegments < MAX_SNAPSHOT_SEGMENTS)
+      {
+         saved = snapshot.append(mLogTips, commits, newCommits);
+         ++mSnapshotSegments;
+      }
+      else
+      {
+         saved = snapshot.save(mLogKey, mLogTips, commits);
+         mSnapshotSegments = 1;
+      }
+
+      if (saved)
+      {
+         mSavedTips = mLogTips;
+         mSnapshotCommits = count;
+      }
+      else
+         mSnapshotCommits = -1;
+   }
+}
+
+QString GitRepoLoader::logOrder() const
+{
    switch (mSettings->localValue("GraphSortingOrder", 0).toInt())
    {
-      case 0:
-         order = "--author-date-order";
-         break;
       case 1:
-         order = "--date-order";
-         break;
+         return "--date-order";
       case 2:
-         order = "--topo-order";
-         break;
+         return "--topo-order";
       default:
-         order = "--author-date-order";
-         break;
+         return "--author-date-order";
    }
+}
 
-   const auto baseCmd = QString("git log %1 --no-color --log-size --parents --boundary -z --pretty=format:%2 %3")
-                            .arg(order, QString::fromUtf8(GIT_LOG_FORMAT), commitsToRetrieve);
+QString GitRepoLoader::logKey() const
+{
+   // The log can only be updated incrementally or stored when it contains everything reachable from the references.
+   const auto maxCommits = mSettings->localValue("MaxCommits", 0).toInt();
 
-   if (!mRevCache->isInitialized())
-      emit signalLoadingStarted();
+   return maxCommits == 0 && mShowAll ? QString("%1 --all").arg(logOrder()) : QString();
+}
 
-   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
-   connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevisions);
-   connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+bool GitRepoLoader::isLogSigned() const
+{
+   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
+   const auto ret = gitConfig->getGitValue("log.showSignature");
+
+   return ret.success ? ret.output.contains("true") : false;
+}
 
-   requestor->run(baseCmd);
+QString GitRepoLoader::snapshotPath() const
+{
+   return QString("%1/GitQlientHistory.cache").arg(mGitBase->getGitDir());
+}
+
+QString GitRepoLoader::changedPathsPath() const
+{
+   return QString("%1/GitQlientChangedPaths.cache").arg(mGitBase->getGitDir());
+}
+
+QMap<QString, QString> GitRepoLoader::readTips() const
+{
+   QMap<QString, QString> tips;
+
+   const auto ret = mGitBase->run("git show-ref -d");
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   const auto lines = ret.output.split('\n', Qt::SkipEmptyParts);
+#else
+   const auto lines = ret.output.split('\n', QString::SkipEmptyParts);
+#endif
+
+   for (const auto &line : lines)
+   {
+      auto refName = line.mid(41).trimmed();
+
+      // The peeled line of an annotated tag points to the commit and overrides the tag object.
+      if (refName.endsWith("^{}"))
+         refName.chop(3);
+
+      tips[refName] = line.left(40);
+   }
+
+   if (mWipParentSha != CommitInfo::INIT_SHA)
+      tips.insert("HEAD", mWipParentSha);
+
+   return tips;
+}
+
+bool GitRepoLoader::loadFromSnapshot()
+{
+   HistorySnapshot snapshot(snapshotPath());
+
+   if (!snapshot.load(mLogKey))
+      return false;
+
+   const auto oldTips = snapshot.tips();
+   auto commits = requestNewCommits(oldTips, mLogTips);
+
+   if (!commits)
+      return false;
+
+   QLog_Info("Git", QString("Using the history snapshot with {%1} new commits on top of it.").arg(commits->count()));
+
+   const auto snapshotCommits = snapshot.takeCommits();
+   commits.value() += snapshotCommits;
+
+   mRevCache->startSetup(mWipParentSha, commits->count());
+   mRevCache->appendCommits(std::move(commits.value()));
+
+   emit signalRevisionsBatchLoaded(mRevCache->commitCount(), true);
+
+   mSavedTips = oldTips;
+   mSnapshotCommits = snapshotCommits.count();
+   mSnapshotSegments = snapshot.segments();
+
+   finishRevisions();
+
+   return true;
+}
+
+std::optional<QVector<CommitInfo>> GitRepoLoader::requestNewCommits(const QMap<QString, QString> &oldTips,
+                                                                    const QMap<QString, QString> &newTips) const
+{
+   QSet<QString> oldShas;
+   QSet<QString> newShas;
+
+   for (const auto &sha : oldTips)
+      oldShas.insert(sha);
+
+   for (const auto &sha : newTips)
+      newShas.insert(sha);
+
+   // The references deleted or moved don't matter as long as their old commits are still reachable: the history only
+   // has to be reloaded when some commits must be removed from it. The cache answers for the references that moved
+   // forward and Git checks the rest at once.
+   QByteArray removedRevisions;
+
+   for (auto iter = oldTips.cbegin(); iter != oldTips.cend(); ++iter)
+   {
+      if (newShas.contains(iter.value()))
+         continue;
+
+      if (const auto currentSha = newTips.value(iter.key());
+          !currentSha.isEmpty() && mRevCache->isAncestor(iter.value(), currentSha).value_or(false))
+      {
+         continue;
+      }
+
+      removedRevisions.append(iter.value().toLatin1()).append('\n');
+   }
+
+   if (!removedRevisions.isEmpty())
+   {
+      for (const auto &sha : qAsConst(newShas))
+         removedRevisions.append('^').append(sha.toLatin1()).append('\n');
+
+      const auto ret = mGitBase->run("git rev-list --max-count=1 --stdin", removedRevisions);
+
+      if (!ret.success || !ret.output.trimmed().isEmpty())
+      {
+         QLog_Info("Git", "Some commits are no longer reachable from the references.");
+         return std::nullopt;
+      }
+   }
+
+   // The revisions are passed through the standard input so there is no limit in the number of references.
+   QByteArray newRevisions;
+
+   for (const auto &sha : qAsConst(newShas))
+   {
+      if (!oldShas.contains(sha))
+         newRevisions.append(sha.toLatin1()).append('\n');
+   }
+
+   QVector<CommitInfo> commits;
+
+   if (!newRevisions.isEmpty())
+   {
+      for (const auto &sha : qAsConst(oldShas))
+         newRevisions.append('^').append(sha.toLatin1()).append('\n');
+
+      const auto cmd = QString("git log %1 --no-color --log-size --parents -z --pretty=format:%2 --stdin")
+                           .arg(logOrder(), QString::fromUtf8(GIT_LOG_FORMAT));
+      // The records are separated by NUL characters: the output is read as bytes so none of them is lost.
+      auto log = mGitBase->runRaw(cmd, newRevisions);
+
+      if (!log)
+         return std::nullopt;
+
+      commits = processUnsignedLog(log.value());
+   }
+
+   return commits;
 }
 
 void GitRepoLoader::processRevisions(QByteArray ba)
@@ -267,9 +957,7 @@ void GitRepoLoader::processRevisions(QByteArray ba)
    if (!initialized)
       emit signalLoadingStarted();
 
-   const auto ret = gitConfig->getGitValue("log.showSignature");
-   const auto showSignature = ret.success ? ret.output.contains("true") : false;
-   auto commits = showSignature ? processSignedLog(ba) : processUnsignedLog(ba);
+   auto commits = isLogSigned() ? processSignedLog(ba) : processUnsignedLog(ba);
    QScopedPointer<GitWip> git(new GitWip(mGitBase, mRevCache));
    const auto files = git->getUntrackedFiles();
 
@@ -278,34 +966,21 @@ void GitRepoLoader::processRevisions(QByteArray ba)
 
    mRevCache->setup(info.first, info.second, std::move(commits));
 
-   --mSteps;
-
-   if (mSteps == 0)
-   {
-      mRevCache->setConfigurationDone();
-
-      emit signalLoadingFinished(mRefreshReferences);
-
-      mLocked = false;
-      mRefreshReferences = false;
-   }
+   onLoadStepFinished();
 }
 
 QVector<CommitInfo> GitRepoLoader::processUnsignedLog(QByteArray &log) const
 {
-   auto lines = log.split('\000');
    QVector<CommitInfo> commits;
-   commits.reserve(lines.count());
-
    auto pos = 0;
-   while (!lines.isEmpty())
-   {
-      if (auto commit = CommitInfo { lines.takeFirst() }; commit.isValid())
+
+   forEachLogRecord(log.constData(), log.constData() + log.size(), [&commits, &pos](std::string_view record) {
+      if (auto commit = CommitInfo { record }; commit.isValid())
       {
          commit.pos = ++pos;
          commits.append(std::move(commit));
       }
-   }
+   });
 
    return commits;
 }
@@ -23,17 +23,24 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ChangedPathsIndex.h>
 #include <CommitInfo.h>
 #include <GitExecResult.h>
 
+#include <QElapsedTimer>
+#include <QMap>
 #include <QObject>
 #include <QSharedPointer>
 #include <QVector>
 
+#include <optional>
+#include <string_view>
+
 struct WipRevisionInfo;
 class GitBase;
 class GitCache;
 class GitQlientSettings;
+class GitRevisionFilesReader;
 class GitTags;
 
 class GitRepoLoader : public QObject
@@ -43,12 +50,37 @@ class GitRepoLoader : public QObject
 signals:
    void signalLoadingStarted();
    void signalLoadingFinished(bool full);
+   /**
+    * @brief signalRevisionsBatchLoaded Signal triggered while the log is being streamed from Git every time a new batch
+    * of commits is available in the cache.
+    * @param totalCommits The total of commits currently stored in the cache, WIP included.
+    * @param firstBatch True if it is the first batch of a new load, otherwise false.
+    */
+   void signalRevisionsBatchLoaded(int totalCommits, bool firstBatch);
+   /**
+    * @brief signalIncrementalLoadFinished Signal triggered when an incremental load finishes.
+    * @param newCommits The number of commits inserted after the WIP.
+    * @param changedRows The number of rows on top of the history whose graph changed, the new ones included.
+    * @param referencesChanged True if the references were reloaded, otherwise false.
+    */
+   void signalIncrementalLoadFinished(int newCommits, int changedRows, bool referencesChanged);
    void cancelAllProcesses(QPrivateSignal);
 
 public slots:
    void loadLogHistory();
    void loadReferences();
    void loadAll();
+   /**
+    * @brief loadIncremental Compares the tips of the references with the ones the history was loaded with and adds the
+    * new commits on top of it. If the history was rewritten it falls back to a full load.
+    */
+   void loadIncremental();
+   /**
+    * @brief prefetchRevisionFiles Loads the files of the commits around the given one into the cache. If several
+    * requests arrive while the files of a previous one are being read, only the last one is processed.
+    * @param sha The SHA of the commit selected.
+    */
+   void prefetchRevisionFiles(const QString &sha);
 
 public:
    explicit GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<GitCache> cache,
@@ -60,17 +92,74 @@ private:
    bool mShowAll = true;
    bool mLocked = false;
    bool mRefreshReferences = true;
+   bool mStreamStarted = false;
+   bool mIncremental = false;
    int mSteps = 0;
+   int mNewCommits = 0;
+   int mChangedRows = 0;
+   QByteArray mLogBuffer;
+   QElapsedTimer mBatchTimer;
+   QString mWipParentSha;
+   QString mLogKey;
+   QMap<QString, QString> mLogTips;
+   QMap<QString, QString> mSavedTips;
+   // The number of commits of the history stored in the snapshot, at the bottom of it, or -1 if they don't match.
+   int mSnapshotCommits = -1;
+   int mSnapshotSegments = 0;
    QSharedPointer<GitBase> mGitBase;
    QSharedPointer<GitCache> mRevCache;
    QSharedPointer<GitQlientSettings> mSettings;
    QSharedPointer<GitTags> mGitTags;
+   QSharedPointer<GitRevisionFilesReader> mRevisionFilesReader;
+   QString mPendingPrefetch;
+   bool mPrefetchScheduled = false;
+
+   /**
+    * @brief The ChangedPathsBuild struct contains the state of the index of the changed paths being read from Git.
+    */
+   struct ChangedPathsBuild
+   {
+      int request = 0;
+      bool replace = false;
+      QMap<QString, QString> tips;
+      QByteArray buffer;
+      ChangedPathsIndex index;
+      QString sha;
+      QString oldPath;
+      int pendingPaths = 0;
+      bool rename = false;
+   };
+   ChangedPathsBuild mChangedPathsBuild;
+   QMap<QString, QString> mIndexedTips;
+   QMap<QString, QString> mSavedIndexTips;
 
    bool configureRepoDirectory();
    void requestReferences();
    void processReferences(QByteArray ba);
    void requestRevisions();
    void processRevisions(QByteArray ba);
+   void processRevisionsChunk(const QByteArray &chunk);
+   void processRevisionsStreamEnd(bool success);
+   void appendStreamedRecords(int end);
+   void finishRevisions();
+   void onLoadStepFinished();
+   void requestLocalBranchDistances();
+   void processPendingPrefetch();
+   void onRevisionFilesRead(const QVector<QPair<QString, QString>> &revisions, const QVector<QString> &outputs);
+   void requestChangedPaths();
+   void processChangedPathsChunk(int request, const QByteArray &chunk);
+   void processChangedPathsField(std::string_view field);
+   void processChangedPathsEnd(int request, bool success);
+   void saveSnapshot();
+   QString logOrder() const;
+   QString logKey() const;
+   bool isLogSigned() const;
+   QString snapshotPath() const;
+   QString changedPathsPath() const;
+   QMap<QString, QString> readTips() const;
+   bool loadFromSnapshot();
+   std::optional<QVector<CommitInfo>> requestNewCommits(const QMap<QString, QString> &oldTips,
+                                                        const QMap<QString, QString> &newTips) const;
    QVector<CommitInfo> processUnsignedLog(QByteArray &log) const;
    QVector<CommitInfo> processSignedLog(QByteArray &log) const;
 };
@@ -0,0 +1,402 @@
+#include "GitRepoWatcher.h"
+
+#include <GitBase.h>
+#include <GitRequestorProcess.h>
+
+#include <QLogger.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QGuiApplication>
+#include <QTimer>
+
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#endif
+
+#include <utility>
+
+using namespace QLogger;
+
+static const auto DEBOUNCE_INTERVAL_MS = 300;
+static const auto MAX_NOTIFICATION_DELAY_MS = 2000;
+// The inotify watches are shared by all the processes of the user. The oldest default limit is 8192.
+static const auto MAX_WATCHED_DIRECTORIES = 8192;
+
+GitRepoWatcher::GitRepoWatcher(const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mGit(git)
+   , mDebounceTimer(new QTimer(this))
+{
+   mDebounceTimer->setSingleShot(true);
+   mDebounceTimer->setInterval(DEBOUNCE_INTERVAL_MS);
+
+   connect(mDebounceTimer, &QTimer::timeout, this, &GitRepoWatcher::notifyChanges);
+   connect(qGuiApp, &QGuiApplication::applicationStateChanged, this, &GitRepoWatcher::onApplicationStateChanged);
+}
+
+GitRepoWatcher::~GitRepoWatcher()
+{
+   stop();
+}
+
+void GitRepoWatcher::start()
+{
+   stop();
+
+   mWorkingDir = QDir::cleanPath(mGit->getWorkingDir());
+   mGitDir = QDir::cleanPath(mGit->getGitDir());
+   mRefsDir = mGitDir + QString("/refs");
+
+   if (mWorkingDir.isEmpty() || mGitDir.isEmpty())
+      return;
+
+#ifdef Q_OS_LINUX
+   mInotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+   if (mInotifyFd == -1)
+   {
+      QLog_Error("Git", "The repository watcher couldn't be initialized.");
+      return;
+   }
+
+   mNotifier = new QSocketNotifier(mInotifyFd, QSocketNotifier::Read, this);
+   connect(mNotifier, &QSocketNotifier::activated, this, &GitRepoWatcher::readEvents);
+#else
+   mWatcher = new QFileSystemWatcher(this);
+   connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, &GitRepoWatcher::onDirectoryChanged);
+
+   for (const auto &fileName : { QString("HEAD"), QString("packed-refs"), QString("index") })
+      mGitFilesStamps.insert(fileName, stampOf(fileName));
+#endif
+
+   addDirectory(mGitDir);
+   addDirectory(mRefsDir);
+
+   QDirIterator refsIter(mRefsDir, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+   while (refsIter.hasNext())
+      addDirectory(refsIter.next());
+
+   addDirectory(mWorkingDir);
+
+   requestWorkingTreeDirectories();
+}
+
+void GitRepoWatcher::stop()
+{
+   mDebounceTimer->stop();
+   mReferencesPending = false;
+   mWorkingTreePending = false;
+   mDirectoriesPending = false;
+   mDirectories.clear();
+   mSkippedDirectories = 0;
+
+   // The listing in progress belongs to the previous start.
+   ++mListingRequest;
+   mListingFiles = false;
+   mListingPending = false;
+
+#ifdef Q_OS_LINUX
+   delete mNotifier;
+   mNotifier = nullptr;
+
+   if (mInotifyFd != -1)
+   {
+      ::close(mInotifyFd);
+      mInotifyFd = -1;
+   }
+
+   mWatches.clear();
+#else
+   delete mWatcher;
+   mWatcher = nullptr;
+
+   mGitFilesStamps.clear();
+#endif
+}
+
+void GitRepoWatcher::addDirectory(const QString &directory)
+{
+   if (mDirectories.contains(directory))
+      return;
+
+   if (mDirectories.count() >= MAX_WATCHED_DIRECTORIES)
+   {
+      if (mSkippedDirectories++ == 0)
+      {
+         QLog_Warning("Git",
+                      "Too many directories to watch. The repository will be refreshed when the application is "
+                      "activated.");
+      }
+
+      return;
+   }
+
+#ifdef Q_OS_LINUX
+   const auto descriptor
+       = inotify_add_watch(mInotifyFd, QFile::encodeName(directory).constData(),
+                           IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+
+   if (descriptor == -1)
+      return;
+
+   mWatches.insert(descriptor, directory);
+#else
+   if (!mWatcher->addPath(directory))
+      return;
+#endif
+
+   mDirectories.insert(directory);
+}
+
+void GitRepoWatcher::removeDirectory(const QString &directory)
+{
+   // The directory is watched again if Git creates it back. The change of its parent triggers the new listing.
+   mDirectories.remove(directory);
+   mDirectoriesPending = true;
+}
+
+bool GitRepoWatcher::isReferencesPath(const QString &directory) const
+{
+   return directory == mRefsDir || directory.startsWith(mRefsDir + QString("/"));
+}
+
+bool GitRepoWatcher::isComplete() const
+{
+#ifdef Q_OS_LINUX
+   return mInotifyFd != -1 && mSkippedDirectories == 0;
+#else
+   return mWatcher && mSkippedDirectories == 0;
+#endif
+}
+
+void GitRepoWatcher::requestWorkingTreeDirectories()
+{
+   // Only one listing runs at a time. The changes that arrive meanwhile are picked by the next one.
+   if (mListingFiles)
+   {
+      mListingPending = true;
+      return;
+   }
+
+   mListingFiles = true;
+
+   const auto request = ++mListingRequest;
+   const auto requestor = new GitRequestorProcess(mWorkingDir);
+   connect(requestor, &GitRequestorProcess::procDataReady, this,
+           [this, request](const QByteArray &files) { processWorkingTreeFiles(request, files); });
+
+   if (!requestor->run("git ls-files -z").success)
+   {
+      mListingFiles = false;
+      requestor->deleteLater();
+   }
+}
+
+void GitRepoWatcher::processWorkingTreeFiles(int request, const QByteArray &files)
+{
+   if (request != mListingRequest)
+      return;
+
+   mListingFiles = false;
+
+   // Only the directories with tracked files are watched. That leaves out build folders and other ignored content that
+   // can change a lot without affecting the repository. New untracked files are still detected in those directories.
+   QSet<QString> directories;
+   auto start = 0;
+
+   while (start < files.size())
+   {
+      auto end = files.indexOf('\0', start);
+
+      if (end == -1)
+         end = files.size();
+
+      // All the parents of a directory are added together, so once one is found the rest are already there.
+      auto separator = files.lastIndexOf('/', end - 1);
+
+      while (separator > start)
+      {
+         const auto directory
+             = mWorkingDir + QString("/") + QString::fromUtf8(files.constData() + start, separator - start);
+
+         if (directories.contains(directory))
+            break;
+
+         directories.insert(directory);
+         addDirectory(directory);
+         separator = files.lastIndexOf('/', separator - 1);
+      }
+
+      start = end + 1;
+   }
+
+   QLog_Debug("Git", QString("Watching {%1} directories of the repository.").arg(mDirectories.count()));
+
+   if (std::exchange(mListingPending, false))
+      requestWorkingTreeDirectories();
+}
+
+void GitRepoWatcher::onFileChanged(const QString &directory, const QString &fileName)
+{
+   // Git writes every file through a lock file that is renamed at the end, so only the final name matters.
+   if (fileName.endsWith(QString(".lock")))
+      return;
+
+   if (directory == mGitDir)
+   {
+      if (fileName == QString("HEAD") || fileName == QString("packed-refs"))
+         mReferencesPending = true;
+      else if (fileName == QString("index"))
+      {
+         // Git writes the index after the files, so the directories it created already exist.
+         mWorkingTreePending = true;
+         mDirectoriesPending = true;
+      }
+      else if (fileName == QString("MERGE_HEAD") || fileName == QString("CHERRY_PICK_HEAD"))
+         mWorkingTreePending = true;
+      else
+         return;
+   }
+   else if (isReferencesPath(directory))
+      mReferencesPending = true;
+   else if (fileName != QString(".git"))
+      mWorkingTreePending = true;
+   else
+      return;
+
+   // The notification is delayed while the changes keep coming, but not forever.
+   if (!mDebounceTimer->isActive())
+      mPendingTimer.start();
+
+   if (mPendingTimer.elapsed() < MAX_NOTIFICATION_DELAY_MS)
+      mDebounceTimer->start();
+}
+
+void GitRepoWatcher::onApplicationStateChanged(Qt::ApplicationState state)
+{
+   // The changes in the directories that aren't watched are only detected when the user comes back.
+   if (state == Qt::ApplicationActive && !mGitDir.isEmpty() && !isComplete())
+   {
+      mReferencesPending = true;
+      notifyChanges();
+   }
+}
+
+void GitRepoWatcher::notifyChanges()
+{
+   const auto notifyReferences = std::exchange(mReferencesPending, false);
+   const auto notifyWorkingTree = std::exchange(mWorkingTreePending, false);
+
+   if (std::exchange(mDirectoriesPending, false))
+      requestWorkingTreeDirectories();
+
+   // The reload of the references refreshes the WIP as well.
+   if (notifyReferences)
+   {
+      QLog_Debug("Git", "The references changed on disk.");
+      emit referencesChanged();
+   }
+   else if (notifyWorkingTree)
+   {
+      QLog_Debug("Git", "The working tree changed on disk.");
+      emit workingTreeChanged();
+   }
+}
+
+#ifdef Q_OS_LINUX
+void GitRepoWatcher::readEvents()
+{
+   alignas(inotify_event) char buffer[4096];
+   ssize_t length;
+
+   while ((length = ::read(mInotifyFd, buffer, sizeof(buffer))) > 0)
+   {
+      for (auto ptr = buffer; ptr < buffer + length;)
+      {
+         const auto event = reinterpret_cast<const inotify_event *>(ptr);
+         ptr += sizeof(inotify_event) + event->len;
+
+         if (event->mask & IN_Q_OVERFLOW)
+         {
+            // Some events were lost so everything is refreshed.
+            onFileChanged(mGitDir, QString("HEAD"));
+            onFileChanged(mGitDir, QString("index"));
+            continue;
+         }
+
+         if (event->mask & IN_IGNORED)
+         {
+            removeDirectory(mWatches.take(event->wd));
+            continue;
+         }
+
+         const auto directory = mWatches.value(event->wd);
+
+         if (directory.isEmpty() || event->len == 0)
+            continue;
+
+         const auto fileName = QFile::decodeName(event->name);
+
+         // New namespaces of references (like the branches of a new remote) need their own watch.
+         if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) && isReferencesPath(directory))
+            addDirectory(directory + QString("/") + fileName);
+
+         onFileChanged(directory, fileName);
+      }
+   }
+}
+#else
+void GitRepoWatcher::onDirectoryChanged(const QString &directory)
+{
+   if (directory == mGitDir)
+   {
+      // QFileSystemWatcher doesn't say which file changed so the relevant ones are compared with the previous state.
+      for (auto iter = mGitFilesStamps.begin(); iter != mGitFilesStamps.end(); ++iter)
+      {
+         if (const auto stamp = stampOf(iter.key()); stamp != iter.value())
+         {
+            iter.value() = stamp;
+            onFileChanged(mGitDir, iter.key());
+         }
+      }
+   }
+   else if (!QFileInfo::exists(directory))
+   {
+      // The watcher drops the directories removed. Their parent reports the change.
+      removeDirectory(directory);
+   }
+   else
+   {
+      if (isReferencesPath(directory))
+      {
+         const auto watched = mWatcher->directories();
+         QDirIterator iter(directory, QDir::Dirs | QDir::NoDotAndDotDot);
+
+         while (iter.hasNext())
+         {
+            if (const auto subdirectory = iter.next(); !watched.contains(subdirectory))
+               addDirectory(subdirectory);
+         }
+      }
+
+      onFileChanged(directory, QString());
+   }
+}
+
+QPair<qint64, qint64> GitRepoWatcher::stampOf(const QString &fileName) const
+{
+   const QFileInfo info(mGitDir + QString("/") + fileName);
+
+   return info.exists() ? qMakePair(info.lastModified().toMSecsSinceEpoch(), info.size()) : qMakePair(-1LL, -1LL);
+}
+#endif
@@ -0,0 +1,129 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+
+class GitBase;
+class QTimer;
+
+#ifdef Q_OS_LINUX
+class QSocketNotifier;
+#else
+class QFileSystemWatcher;
+#endif
+
+/**
+ * @brief The GitRepoWatcher class watches the Git directory and the working tree of a repository and notifies which
+ * kind of refresh is needed when something changes on disk.
+ *
+ * On Linux it uses inotify directly so the events carry the name of the file that changed and they can be classified
+ * without touching the disk. On the other platforms it falls back to QFileSystemWatcher and compares the timestamps of
+ * the files in the Git directory.
+ *
+ * The events are coalesced: a burst of changes (like a checkout or a build writing files) only triggers one
+ * notification of each kind once the disk has been quiet for a short period.
+ *
+ * The directories of the working tree are listed by Git in the background, and listed again when the index or the
+ * references change so the directories created or removed by Git are watched again. When not everything can be watched
+ * the repository is refreshed every time the application is activated.
+ */
+class GitRepoWatcher : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief referencesChanged Signal triggered when HEAD or any reference changed.
+    */
+   void referencesChanged();
+
+   /**
+    * @brief workingTreeChanged Signal triggered when the index or the files in the working tree changed.
+    */
+   void workingTreeChanged();
+
+public:
+   /**
+    * @brief Default constructor.
+    * @param git The git object to perform Git operations.
+    * @param parent The parent object if needed.
+    */
+   explicit GitRepoWatcher(const QSharedPointer<GitBase> &git, QObject *parent = nullptr);
+   ~GitRepoWatcher() override;
+
+   /**
+    * @brief start Starts watching the repository. If it was already started, the watched paths are refreshed.
+    */
+   void start();
+
+   /**
+    * @brief stop Stops watching the repository and discards the pending notifications.
+    */
+   void stop();
+
+private:
+   QSharedPointer<GitBase> mGit;
+   QString mGitDir;
+   QString mRefsDir;
+   QString mWorkingDir;
+   QTimer *mDebounceTimer = nullptr;
+   QElapsedTimer mPendingTimer;
+   QSet<QString> mDirectories;
+   int mSkippedDirectories = 0;
+   int mListingRequest = 0;
+   bool mListingFiles = false;
+   bool mListingPending = false;
+   bool mReferencesPending = false;
+   bool mWorkingTreePending = false;
+   bool mDirectoriesPending = false;
+
+#ifdef Q_OS_LINUX
+   int mInotifyFd = -1;
+   QSocketNotifier *mNotifier = nullptr;
+   QHash<int, QString> mWatches;
+
+   void readEvents();
+#else
+   QFileSystemWatcher *mWatcher = nullptr;
+   QHash<QString, QPair<qint64, qint64>> mGitFilesStamps;
+
+   void onDirectoryChanged(const QString &directory);
+   QPair<qint64, qint64> stampOf(const QString &fileName) const;
+#endif
+
+   void addDirectory(const QString &directory);
+   void removeDirectory(const QString &directory);
+   bool isReferencesPath(const QString &directory) const;
+   bool isComplete() const;
+   void requestWorkingTreeDirectories();
+   void processWorkingTreeFiles(int request, const QByteArray &files);
+   void onFileChanged(const QString &directory, const QString &fileName);
+   void onApplicationStateChanged(Qt::ApplicationState state);
+   void notifyChanges();
+};
@@ -0,0 +1,171 @@
+#include "GitRevisionFilesReader.h"
+
+#include <AGitProcess.h>
+
+#include <QLogger.h>
+
+#include <QProcess>
+
+using namespace QLogger;
+
+static const auto RESPONSE_TIMEOUT_MS = 5000;
+static const auto MAX_FAILED_STARTS = 3;
+static const QByteArray END_MARKER("#end");
+
+GitRevisionFilesReader::GitRevisionFilesReader(const QString &workingDir, QObject *parent)
+   : QObject(parent)
+   , mWorkingDir(workingDir)
+{
+   mTimeout.setSingleShot(true);
+   mTimeout.setInterval(RESPONSE_TIMEOUT_MS);
+
+   connect(&mTimeout, &QTimer::timeout, this, [this]() {
+      QLog_Warning("Git", "The revision files reader stopped answering. It will be restarted.");
+      fail();
+   });
+}
+
+GitRevisionFilesReader::~GitRevisionFilesReader()
+{
+   reset();
+}
+
+bool GitRevisionFilesReader::read(const QVector<QPair<QString, QString>> &revisions)
+{
+   if (isBusy() || revisions.isEmpty())
+      return false;
+
+   QByteArray request;
+
+   for (const auto &revision : revisions)
+   {
+      if (revision.first.isEmpty() || revision.second.isEmpty())
+         return false;
+
+      request.append(QString("%1 %2\n").arg(revision.first, revision.second).toLatin1());
+      request.append(END_MARKER);
+      request.append('\n');
+   }
+
+   if (!ensureStarted())
+      return false;
+
+   mRevisions = revisions;
+   mOutputs.clear();
+   mOutputs.reserve(revisions.count());
+   mOutput.clear();
+
+   mProcess->write(request);
+   mTimeout.start();
+
+   return true;
+}
+
+bool GitRevisionFilesReader::ensureStarted()
+{
+   if (mProcess && mProcess->state() == QProcess::Running)
+      return true;
+
+   reset();
+
+   if (mFailedStarts >= MAX_FAILED_STARTS)
+      return false;
+
+   mProcess.reset(new QProcess());
+   mProcess->setWorkingDirectory(mWorkingDir);
+   mProcess->setStandardErrorFile(QProcess::nullDevice());
+
+   if (!AGitProcess::startGitProcess(mProcess.data(),
+                                     { "git", "diff-tree", "--stdin", "-C", "--no-color", "-r", "-m" }))
+   {
+      QLog_Warning("Git", QString("Unable to start the revision files reader: %1").arg(mProcess->errorString()));
+
+      ++mFailedStarts;
+      reset();
+
+      return false;
+   }
+
+   connect(mProcess.data(), &QProcess::readyReadStandardOutput, this, &GitRevisionFilesReader::processOutput);
+   connect(mProcess.data(), qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, [this]() {
+      if (isBusy())
+      {
+         QLog_Warning("Git", "The revision files reader finished before answering.");
+         fail();
+      }
+   });
+
+   QLog_Debug("Git", QString("Revision files reader started for {%1}.").arg(mWorkingDir));
+
+   mFailedStarts = 0;
+
+   return true;
+}
+
+void GitRevisionFilesReader::processOutput()
+{
+   // The answer of each commit is its SHA (only if it changed anything) followed by one line per file and the marker.
+   while (isBusy() && mProcess->canReadLine())
+   {
+      auto line = mProcess->readLine();
+      line.chop(1);
+
+      if (line == END_MARKER)
+      {
+         mOutputs.append(QString::fromUtf8(mOutput));
+         mOutput.clear();
+
+         if (mOutputs.count() == mRevisions.count())
+         {
+            mTimeout.stop();
+
+            const auto revisions = std::move(mRevisions);
+            const auto outputs = std::move(mOutputs);
+            mRevisions.clear();
+            mOutputs.clear();
+
+            emit revisionFilesRead(revisions, outputs);
+            return;
+         }
+      }
+      else if (line.startsWith(':'))
+      {
+         mOutput.append(line);
+         mOutput.append('\n');
+      }
+   }
+
+   if (isBusy())
+      mTimeout.start();
+}
+
+void GitRevisionFilesReader::fail()
+{
+   mTimeout.stop();
+
+   const auto revisions = std::move(mRevisions);
+   mRevisions.clear();
+   mOutputs.clear();
+   mOutput.clear();
+
+   reset();
+
+   emit revisionFilesRead(revisions, {});
+}
+
+void GitRevisionFilesReader::reset()
+{
+   if (mProcess)
+   {
+      // The process is not followed anymore: its end is not a failure of the next request.
+      mProcess->disconnect(this);
+
+      // Closing the input makes diff-tree finish by itself.
+      mProcess->closeWriteChannel();
+
+      if (!mProcess->waitForFinished(100))
+         mProcess->kill();
+
+      mProcess.reset();
+   }
+}
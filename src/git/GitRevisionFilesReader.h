@@ -0,0 +1,89 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QObject>
+#include <QPair>
+#include <QScopedPointer>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class QProcess;
+
+/**
+ * @brief The GitRevisionFilesReader class keeps a `git diff-tree --stdin` process alive to get the files modified by
+ * several commits without starting a new Git process for each of them.
+ *
+ * Every request is followed by a line that isn't a SHA: diff-tree echoes it and flushes its output, so it marks where
+ * the answer of each commit ends. The process is started on the first request and restarted if it stops answering.
+ *
+ * The answers are read as they arrive, so the thread that uses the reader is never blocked waiting for Git. Like any
+ * QProcess, an instance must only be used from the thread that created it.
+ */
+class GitRevisionFilesReader final : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief revisionFilesRead Signal triggered when the answer to a request is complete or the helper process couldn't
+    * answer it.
+    * @param revisions The pairs of SHAs of the request.
+    * @param outputs The output for each revision in the same order as @p revisions, in the same format
+    * `git diff-tree -r` gives when comparing two commits. Empty if the helper process couldn't answer.
+    */
+   void revisionFilesRead(const QVector<QPair<QString, QString>> &revisions, const QVector<QString> &outputs);
+
+public:
+   explicit GitRevisionFilesReader(const QString &workingDir, QObject *parent = nullptr);
+   ~GitRevisionFilesReader() override;
+
+   /**
+    * @brief read Requests the files of several commits in a single round trip to the helper process. The method
+    * returns immediately and the answer is notified with @ref revisionFilesRead.
+    * @param revisions The pairs of SHAs of the commits and the parent they are compared to.
+    * @return False if another request is still being answered or the helper process couldn't start.
+    */
+   bool read(const QVector<QPair<QString, QString>> &revisions);
+
+   /**
+    * @brief isBusy Checks if a request is still being answered.
+    */
+   bool isBusy() const { return !mRevisions.isEmpty(); }
+
+private:
+   QString mWorkingDir;
+   QScopedPointer<QProcess> mProcess;
+   int mFailedStarts = 0;
+   QVector<QPair<QString, QString>> mRevisions;
+   QVector<QString> mOutputs;
+   QByteArray mOutput;
+   QTimer mTimeout;
+
+   bool ensureStarted();
+   void processOutput();
+   void fail();
+   void reset();
+};
@@ -0,0 +1,37 @@
+#include "GitStreamProcess.h"
+
+GitStreamProcess::GitStreamProcess(const QString &workingDir)
+   : AGitProcess(workingDir)
+{
+}
+
+GitExecResult GitStreamProcess::run(const QString &command)
+{
+   const auto ret = execute(command);
+
+   return { ret, "" };
+}
+
+void GitStreamProcess::onReadyStandardOutput()
+{
+   if (!mCanceling)
+   {
+      // The output is not stored in mRunOutput: the receiver owns the data and keeping a copy here would double the
+      // memory used by huge outputs.
+      if (const auto standardOutput = readAllStandardOutput(); !standardOutput.isEmpty())
+         emit procDataReady(standardOutput);
+   }
+}
+
+void GitStreamProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+   if (!mCanceling)
+      onReadyStandardOutput();
+
+   AGitProcess::onFinished(exitCode, exitStatus);
+
+   if (!mCanceling)
+      emit signalStreamFinished(!mRealError);
+
+   deleteLater();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <AGitProcess.h>
+
+/**
+ * @brief The GitStreamProcess class runs a Git command and forwards its standard output as it arrives instead of
+ * buffering it until the process finishes. It is meant for commands with a very large output (like the full log of a
+ * big repository) where the consumer can start working with the first chunks while Git is still producing the rest.
+ *
+ * The object deletes itself once the process finishes.
+ */
+class GitStreamProcess : public AGitProcess
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief signalStreamFinished Signal triggered when the process finished and all the output has been forwarded
+    * through the @ref procDataReady signal.
+    * @param success True if the process finished without errors, otherwise false.
+    */
+   void signalStreamFinished(bool success);
+
+public:
+   explicit GitStreamProcess(const QString &workingDir);
+   GitExecResult run(const QString &command) override;
+
+protected:
+   void onReadyStandardOutput() override;
+
+private:
+   void onFinished(int exitCode, QProcess::ExitStatus exitStatus) override;
+};
@@ -3,6 +3,12 @@
 #include <QTemporaryFile>
 #include <QTextStream>
 
+#include <QLogger.h>
+
+using namespace QLogger;
+
+static const auto RUN_TIMEOUT_MS = 10000;
+
 GitSyncProcess::GitSyncProcess(const QString &workingDir)
    : AGitProcess(workingDir)
 {
@@ -12,10 +18,45 @@ GitExecResult GitSyncProcess::run(const QString &command)
 {
    const auto processStarted = execute(command);
 
-   if (processStarted)
-      waitForFinished(10000);
+   // The caller is blocked while the command runs, usually in the UI thread, so the wait is bounded.
+   const auto timedOut = processStarted && !waitForFinished(RUN_TIMEOUT_MS) && state() != QProcess::NotRunning;
 
    close();
 
+   if (timedOut)
+   {
+      QLog_Error("Git", QString("Git command {%1} didn't finish in %2 ms.").arg(command).arg(RUN_TIMEOUT_MS));
+
+      return { false, mRunOutput };
+   }
+
    return { !mRealError, mRunOutput };
 }
+
+std::optional<QByteArray> GitSyncProcess::runRaw(const QString &command)
+{
+   mRaw = true;
+   mRawOutput.clear();
+
+   if (const auto ret = run(command); !ret.success)
+      return std::nullopt;
+
+   return mRawOutput;
+}
+
+void GitSyncProcess::onReadyStandardOutput()
+{
+   if (!mRaw)
+      AGitProcess::onReadyStandardOutput();
+   else if (!mCanceling)
+      mRawOutput.append(readAllStandardOutput());
+}
+
+void GitSyncProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+   // The output still buffered is taken before the base class converts it to text.
+   if (mRaw && !mCanceling)
+      mRawOutput.append(readAllStandardOutput());
+
+   AGitProcess::onFinished(exitCode, exitStatus);
+}
@@ -25,10 +25,29 @@
 
 #include "AGitProcess.h"
 
+#include <optional>
+
 class GitSyncProcess final : public AGitProcess
 {
 public:
    GitSyncProcess(const QString &workingDir);
 
    GitExecResult run(const QString &command) override;
+
+   /**
+    * @brief runRaw Runs a command and returns its standard output as Git wrote it, without converting it to text. The
+    * conversion to QString stops at the first NUL, so the commands with -z must be read this way.
+    * @param command The command to run.
+    * @return The output, or std::nullopt if the command failed.
+    */
+   std::optional<QByteArray> runRaw(const QString &command);
+
+protected:
+   void onReadyStandardOutput() override;
+
+private:
+   bool mRaw = false;
+   QByteArray mRawOutput;
+
+   void onFinished(int exitCode, QProcess::ExitStatus exitStatus) override;
 };
@@ -110,7 +110,7 @@ GitExecResult GitTags::getTagCommit(const QString &tagName)
 
    QLog_Trace("Git", QString("Getting the commit of a tag: {%1}").arg(cmd));
 
-   const auto ret = mGitBase->run(cmd);
+   const auto ret = mGitBase->resolveRevision(QString("%1^{commit}").arg(tagName), cmd);
    const auto output = ret.output.trimmed();
 
    return qMakePair(ret.success, output);
@@ -118,7 +118,7 @@ GitExecResult GitTags::getTagCommit(const QString &tagName)
 
 void GitTags::onRemoteTagsRecieved(GitExecResult result)
 {
-   QMap<QString, QString> tags;
+   QHash<QString, QString> tags;
 
    if (result.success)
    {
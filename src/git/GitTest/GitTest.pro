@@ -0,0 +1,22 @@
+QT += widgets core network webenginewidgets webchannel testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = GitTest
+
+# The test runs the Git classes against temporary repositories, so it builds them with the rest of GitQlient.
+include($$PWD/../../App.pri)
+include($$PWD/../../../QLogger/QLogger.pri)
+
+INCLUDEPATH += $$PWD/../../../QLogger
+
+DEFINES += \
+    VER=\\\"0.0\\\" \
+    SHA_VER=\\\"0\\\" \
+    QT_NO_JAVA_STYLE_ITERATORS \
+    QT_DISABLE_DEPRECATED_BEFORE=0x050900 \
+    QT_USE_QSTRINGBUILDER
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,171 @@
+#include <AGitProcess.h>
+#include <GitBase.h>
+#include <GitCache.h>
+#include <GitHistory.h>
+#include <GitQlientSettings.h>
+#include <GitRepoLoader.h>
+#include <RevisionFiles.h>
+
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace
+{
+// The loads run in processes of their own, so the waits are generous.
+const auto LOAD_TIMEOUT = 30000;
+}
+
+class GitTest : public QObject
+{
+   Q_OBJECT
+
+private slots:
+   void initTestCase();
+   void init();
+   void cleanup();
+   void incrementalLoadReadsEveryCommit();
+   void openingCommitSpawnsOneProcess();
+
+private:
+   QTemporaryDir mRepo;
+   QSharedPointer<GitBase> mGit;
+   QSharedPointer<GitCache> mCache;
+   QSharedPointer<GitQlientSettings> mSettings;
+   QSharedPointer<GitRepoLoader> mLoader;
+
+   QString git(const QStringList &arguments) const;
+   QString commit(const QString &message) const;
+   bool loadAll();
+   bool openCommit(const QString &sha);
+};
+
+void GitTest::initTestCase()
+{
+   // The settings of the user are not touched.
+   QStandardPaths::setTestModeEnabled(true);
+
+   QVERIFY(mRepo.isValid());
+
+   git({ "init", "-q" });
+   git({ "config", "user.name", "GitQlient" });
+   git({ "config", "user.email", "gitqlient@example.com" });
+   commit("Initial commit");
+}
+
+void GitTest::init()
+{
+   mGit.reset(new GitBase(mRepo.path()));
+   mCache.reset(new GitCache());
+   mSettings.reset(new GitQlientSettings(mRepo.filePath(".git")));
+   mLoader.reset(new GitRepoLoader(mGit, mCache, mSettings));
+}
+
+void GitTest::cleanup()
+{
+   mLoader.reset();
+   mSettings.reset();
+   mCache.reset();
+   mGit.reset();
+}
+
+void GitTest::incrementalLoadReadsEveryCommit()
+{
+   QVERIFY(loadAll());
+
+   const auto commitsBefore = mCache->commitCount();
+
+   // A branch and the current one move at the same time, so the new commits are read with several tips in the input.
+   QStringList newShas;
+   const auto base = git({ "rev-parse", "HEAD" });
+
+   for (auto i = 0; i < 5; ++i)
+      newShas.append(commit(QString("Commit %1 of the refresh").arg(i)));
+
+   git({ "checkout", "-q", "-b", "feature", base });
+
+   for (auto i = 0; i < 3; ++i)
+      newShas.append(commit(QString("Commit %1 of the branch").arg(i)));
+
+   QSignalSpy loaded(mLoader.get(), &GitRepoLoader::signalIncrementalLoadFinished);
+   mLoader->loadIncremental();
+
+   QTRY_COMPARE_WITH_TIMEOUT(loaded.count(), 1, LOAD_TIMEOUT);
+   QCOMPARE(loaded.first().at(0).toInt(), newShas.count());
+   QCOMPARE(mCache->commitCount(), commitsBefore + newShas.count());
+
+   for (const auto &sha : qAsConst(newShas))
+      QVERIFY2(mCache->commitRow(sha) > 0, qPrintable(sha));
+}
+
+void GitTest::openingCommitSpawnsOneProcess()
+{
+   QVERIFY(loadAll());
+
+   const auto sha = git({ "rev-parse", "HEAD" });
+
+   // The steps run synchronously, so the processes the loader starts in the background are not counted.
+   const auto spawnedBefore = AGitProcess::spawnedProcesses();
+   QVERIFY(openCommit(sha));
+
+   // Only the files of the commit are read from Git.
+   QCOMPARE(AGitProcess::spawnedProcesses() - spawnedBefore, quint64(1));
+
+   // The second time they come from the cache.
+   const auto spawnedAfterFirstOpen = AGitProcess::spawnedProcesses();
+   QVERIFY(openCommit(sha));
+
+   QCOMPARE(AGitProcess::spawnedProcesses() - spawnedAfterFirstOpen, quint64(0));
+}
+
+QString GitTest::git(const QStringList &arguments) const
+{
+   QProcess p;
+   p.setWorkingDirectory(mRepo.path());
+   p.start("git", arguments);
+
+   if (!p.waitForFinished(LOAD_TIMEOUT) || p.exitCode() != 0)
+      qFatal("git %s failed: %s", qPrintable(arguments.join(' ')), p.readAllStandardError().constData());
+
+   return QString::fromUtf8(p.readAllStandardOutput()).trimmed();
+}
+
+QString GitTest::commit(const QString &message) const
+{
+   git({ "commit", "-q", "--allow-empty", "-m", message });
+
+   return git({ "rev-parse", "HEAD" });
+}
+
+bool GitTest::loadAll()
+{
+   QSignalSpy loaded(mLoader.get(), &GitRepoLoader::signalLoadingFinished);
+   mLoader->loadAll();
+
+   return loaded.count() == 1 || loaded.wait(LOAD_TIMEOUT);
+}
+
+bool GitTest::openCommit(const QString &sha)
+{
+   // The same steps as CommitInfoWidget::configure and FileListWidget::insertFiles, without the widgets.
+   const auto commit = mCache->commitInfo(sha);
+
+   if (commit.sha.isEmpty())
+      return false;
+
+   if (mCache->revisionFile(commit.sha, commit.firstParent()))
+      return true;
+
+   QScopedPointer<GitHistory> git(new GitHistory(mGit));
+   const auto ret = git->getDiffFiles(commit.sha, commit.firstParent());
+
+   if (ret.success)
+      mCache->insertRevisionFiles(commit.sha, commit.firstParent(), RevisionFiles(ret.output));
+
+   return ret.success;
+}
+
+QTEST_GUILESS_MAIN(GitTest)
+
+#include "main.moc"
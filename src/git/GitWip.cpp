@@ -34,9 +34,10 @@ std::optional<QPair<QString, RevisionFiles>> GitWip::getWipInfo() const
 {
    QLog_Debug("Git", QString("Executing processWip."));
 
-   const auto ret = mGit->run("git rev-parse --revs-only HEAD");
+   const auto ret = mGit->resolveRevision("HEAD", "git rev-parse --revs-only HEAD");
 
-   if (ret.success)
+   // A branch without commits can't be resolved but it still has a WIP.
+   if (ret.success || ret.output.isEmpty())
    {
       QString diffIndex;
       QString diffIndexCached;
@@ -148,7 +148,7 @@ void CommitHistoryContextMenu::createIndividualShaMenu()
 
          const auto copyTitleAction = copyMenu->addAction(tr("Commit title"));
          connect(copyTitleAction, &QAction::triggered, this, [this]() {
-            const auto title = mCache->commitInfo(mShas.first()).shortLog;
+            const auto title = mCache->commitShortLog(mShas.first());
             QApplication::clipboard()->setText(title);
          });
       }
@@ -384,8 +384,8 @@ void CommitHistoryContextMenu::cherryPickCommit()
          commit.sha = mGit->getLastCommit().output.trimmed();
 
          mCache->insertCommit(commit);
-         mCache->deleteReference(lastShaBeforeCommit, References::Type::LocalBranch, mGit->getCurrentBranch());
-         mCache->insertReference(commit.sha, References::Type::LocalBranch, mGit->getCurrentBranch());
+         mCache->moveReference(lastShaBeforeCommit, commit.sha, References::Type::LocalBranch,
+                               mGit->getCurrentBranch());
 
          QScopedPointer<GitHistory> gitHistory(new GitHistory(mGit));
          const auto ret = gitHistory->getDiffFiles(commit.sha, lastShaBeforeCommit);
@@ -462,10 +462,8 @@ void CommitHistoryContextMenu::push()
          const auto oldSha = mCache->getShaOfReference(QString("%1/%2").arg(remote.output, currentBranch),
                                                        References::Type::RemoteBranches);
          const auto sha = mCache->getShaOfReference(currentBranch, References::Type::LocalBranch);
-         mCache->deleteReference(oldSha, References::Type::RemoteBranches,
-                                 QString("%1/%2").arg(remote.output, currentBranch));
-         mCache->insertReference(sha, References::Type::RemoteBranches,
-                                 QString("%1/%2").arg(remote.output, currentBranch));
+         mCache->moveReference(oldSha, sha, References::Type::RemoteBranches,
+                               QString("%1/%2").arg(remote.output, currentBranch));
          emit mCache->signalCacheUpdated();
          emit signalRefreshPRsCache();
       }
@@ -526,8 +524,7 @@ void CommitHistoryContextMenu::resetSoft()
 
    if (git->resetCommit(mShas.first(), GitLocal::CommitResetType::SOFT))
    {
-      mCache->deleteReference(previousSha, References::Type::LocalBranch, mGit->getCurrentBranch());
-      mCache->insertReference(mShas.first(), References::Type::LocalBranch, mGit->getCurrentBranch());
+      mCache->moveReference(previousSha, mShas.first(), References::Type::LocalBranch, mGit->getCurrentBranch());
 
       emit logReload();
    }
@@ -540,8 +537,7 @@ void CommitHistoryContextMenu::resetMixed()
 
    if (git->resetCommit(mShas.first(), GitLocal::CommitResetType::MIXED))
    {
-      mCache->deleteReference(previousSha, References::Type::LocalBranch, mGit->getCurrentBranch());
-      mCache->insertReference(mShas.first(), References::Type::LocalBranch, mGit->getCurrentBranch());
+      mCache->moveReference(previousSha, mShas.first(), References::Type::LocalBranch, mGit->getCurrentBranch());
 
       emit logReload();
    }
@@ -560,8 +556,7 @@ void CommitHistoryContextMenu::resetHard()
 
       if (git->resetCommit(mShas.first(), GitLocal::CommitResetType::HARD))
       {
-         mCache->deleteReference(previousSha, References::Type::LocalBranch, mGit->getCurrentBranch());
-         mCache->insertReference(mShas.first(), References::Type::LocalBranch, mGit->getCurrentBranch());
+         mCache->moveReference(previousSha, mShas.first(), References::Type::LocalBranch, mGit->getCurrentBranch());
 
          emit logReload();
       }
@@ -26,7 +26,7 @@ CommitHistoryModel::CommitHistoryModel(const QSharedPointer<GitCache> &cache, co
 
 int CommitHistoryModel::rowCount(const QModelIndex &parent) const
 {
-   return !parent.isValid() ? mCache->commitCount() : 0;
+   return !parent.isValid() ? mRowCount : 0;
 }
 
 bool CommitHistoryModel::hasChildren(const QModelIndex &parent) const
@@ -42,6 +42,8 @@ QString CommitHistoryModel::sha(int row) const
 void CommitHistoryModel::clear()
 {
    beginResetModel();
+   mRowCount = 0;
+   mState.reset();
    endResetModel();
    emit headerDataChanged(Qt::Horizontal, 0, 5);
 }
@@ -49,10 +51,55 @@ void CommitHistoryModel::clear()
 void CommitHistoryModel::onNewRevisions(int totalCommits)
 {
    beginResetModel();
+   mRowCount = totalCommits;
+   mState = mCache->renderState();
    endResetModel();
+}
+
+void CommitHistoryModel::onRevisionsAppended(int totalCommits)
+{
+   // The rows appended don't change the graph of the ones above them.
+   if (totalCommits > mRowCount)
+   {
+      beginInsertRows(QModelIndex(), mRowCount, totalCommits - 1);
+      mRowCount = totalCommits;
+      mState = mCache->renderState();
+      endInsertRows();
+   }
+}
+
+void CommitHistoryModel::onRevisionsInserted(int first, int count, int changedRows)
+{
+   const auto state = mCache->renderState();
+
+   // The cache can have changed again since the notification was sent: the rows are not known anymore.
+   if (state->commits.count() != mRowCount + count)
+   {
+      onNewRevisions(state->commits.count());
+      return;
+   }
 
-   beginInsertRows(QModelIndex(), 0, totalCommits - 2);
-   endInsertRows();
+   if (count > 0)
+   {
+      beginInsertRows(QModelIndex(), first, first + count - 1);
+      mRowCount += count;
+      mState = state;
+      endInsertRows();
+   }
+   else
+      mState = state;
+
+   // Only the graph of the rows on top changes: below them it's the same as before.
+   if (const auto lastRow = qMin(changedRows, mRowCount) - 1; lastRow >= 0)
+      emit dataChanged(index(0, 0), index(lastRow, columnCount() - 1));
+}
+
+std::shared_ptr<const GitCache::RenderState> CommitHistoryModel::renderState() const
+{
+   // The rows of two versions with the same shift are the same: only the version with new rows on top must wait.
+   const auto state = mCache->renderState();
+
+   return mState && state->rowShift != mState->rowShift ? mState : state;
 }
 
 QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -65,7 +112,7 @@ QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation
 
 QModelIndex CommitHistoryModel::index(int row, int column, const QModelIndex &) const
 {
-   return row >= 0 && row < mCache->commitCount() ? createIndex(row, column, nullptr) : QModelIndex();
+   return row >= 0 && row < mRowCount ? createIndex(row, column, nullptr) : QModelIndex();
 }
 
 QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
@@ -73,43 +120,46 @@ QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
    return QModelIndex();
 }
 
-QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
+QVariant CommitHistoryModel::getToolTipData(const GitCache::RenderState &state, int row) const
 {
    QString auxMessage;
-   const auto sha = r.sha;
+   const auto &commits = state.commits;
+   const auto sha = commits.sha(row);
+   const auto references = state.references.value(sha);
 
-   if (mGit->getCurrentBranch().isEmpty())
+   if (state.detached)
       auxMessage.append(tr("<p>Status: <b>detached</b></p>"));
 
-   const auto localBranches = mCache->getReferences(sha, References::Type::LocalBranch);
+   const auto localBranches = references.getReferences(References::Type::LocalBranch);
 
    if (!localBranches.isEmpty())
       auxMessage.append(tr("<p><b>Local: </b>%1</p>").arg(localBranches.join(",")));
 
-   const auto remoteBranches = mCache->getReferences(sha, References::Type::RemoteBranches);
+   const auto remoteBranches = references.getReferences(References::Type::RemoteBranches);
 
    if (!remoteBranches.isEmpty())
       auxMessage.append(tr("<p><b>Remote: </b>%1</p>").arg(remoteBranches.join(",")));
 
-   const auto tags = mCache->getReferences(sha, References::Type::LocalTag);
+   const auto tags = references.getReferences(References::Type::LocalTag);
 
    if (!tags.isEmpty())
       auxMessage.append(tr("<p><b>Tags: </b>%1</p>").arg(tags.join(",")));
 
    QDateTime d;
-   d.setSecsSinceEpoch(r.dateSinceEpoch.count());
+   d.setSecsSinceEpoch(commits.date(row));
 
    QLocale locale;
 
+   const auto signature = commits.isSigned(row)
+       ? tr("<p> GPG key (%1): %2</p>")
+             .arg(QString::fromUtf8(commits.verifiedSignature(row) ? "verified" : "not verified"), commits.gpgKey(row))
+       : QString();
+
    auto tooltip = sha == CommitInfo::ZERO_SHA
        ? QString()
        : QString("<p>%1 - %2</p><p>%3</p>%4%5")
-             .arg(r.author.split("<").first(), d.toString(locale.dateTimeFormat(QLocale::ShortFormat)), sha,
-                  !auxMessage.isEmpty() ? QString("<p>%1</p>").arg(auxMessage) : "",
-                  r.isSigned()
-                      ? tr("<p> GPG key (%1): %2</p>")
-                            .arg(QString::fromUtf8(r.verifiedSignature() ? "verified" : "not verified"), r.gpgKey)
-                      : "");
+             .arg(commits.author(row).section('<', 0, 0), d.toString(locale.dateTimeFormat(QLocale::ShortFormat)),
+                  sha, !auxMessage.isEmpty() ? QString("<p>%1</p>").arg(auxMessage) : "", signature);
 
    if (mGitServerCache)
    {
@@ -120,22 +170,20 @@ QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
    return tooltip;
 }
 
-QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) const
+QVariant CommitHistoryModel::getDisplayData(const CommitPages &commits, int row, int column) const
 {
    switch (static_cast<CommitHistoryColumns>(column))
    {
-      case CommitHistoryColumns::Sha: {
-         const auto sha = rev.sha;
-         return sha;
-      }
+      case CommitHistoryColumns::Sha:
+         return commits.sha(row);
       case CommitHistoryColumns::Log:
-         return rev.shortLog;
+         return commits.shortLog(row);
       case CommitHistoryColumns::Author: {
-         const auto author = rev.author.split("<").first();
+         const auto author = commits.author(row).section('<', 0, 0);
          return author;
       }
       case CommitHistoryColumns::Date: {
-         return QDateTime::fromSecsSinceEpoch(rev.dateSinceEpoch.count()).toString("dd MMM yyyy hh:mm");
+         return QDateTime::fromSecsSinceEpoch(commits.date(row)).toString("dd MMM yyyy hh:mm");
       }
       default:
          return QVariant();
@@ -147,13 +195,18 @@ QVariant CommitHistoryModel::data(const QModelIndex &index, int role) const
    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
       return QVariant();
 
-   const auto r = mCache->commitInfo(index.row());
+   // The snapshot keeps the commit alive while it's read without locking the cache. Only the fields needed are read:
+   // the commit is not built.
+   const auto state = renderState();
+
+   if (index.row() >= state->commits.count())
+      return QVariant();
 
    if (role == Qt::ToolTipRole)
-      return getToolTipData(r);
+      return getToolTipData(*state, index.row());
 
    if (role == Qt::DisplayRole)
-      return getDisplayData(r, index.column());
+      return getDisplayData(state->commits, index.row(), index.column());
 
    return QVariant();
 }
@@ -23,12 +23,14 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitCache.h>
+
 #include <QAbstractItemModel>
 #include <QSharedPointer>
 
-class GitCache;
+#include <memory>
+
 class GitBase;
-class CommitInfo;
 class GitServerCache;
 enum class CommitHistoryColumns;
 
@@ -125,6 +127,28 @@ public:
     * @param totalCommits The total of new revisions.
     */
    void onNewRevisions(int totalCommits);
+   /**
+    * @brief Appends the rows of the revisions added to the cache since the last update without resetting the model.
+    *
+    * @param totalCommits The new total of revisions.
+    */
+   void onRevisionsAppended(int totalCommits);
+   /**
+    * @brief Inserts the rows of the revisions added in the middle of the cache without resetting the model.
+    *
+    * @param first The first row inserted.
+    * @param count The number of rows inserted.
+    * @param changedRows The number of rows on top whose graph changed, the inserted ones included.
+    */
+   void onRevisionsInserted(int first, int count, int changedRows);
+   /**
+    * @brief Returns the version of the history the rows of the model belong to. The cache publishes the commits
+    * inserted on top before the model is told to insert their rows: until then, the version the model was last updated
+    * with is used.
+    *
+    * @return The render state to read the rows from.
+    */
+   std::shared_ptr<const GitCache::RenderState> renderState() const;
    /*!
     * \brief Gets the number of columns in the model.
     * \return The number of columns.
@@ -136,20 +160,25 @@ private:
    QSharedPointer<GitBase> mGit;
    QSharedPointer<GitServerCache> mGitServerCache;
    QMap<CommitHistoryColumns, QString> mColumns;
+   int mRowCount = 0;
+   std::shared_ptr<const GitCache::RenderState> mState;
 
    /**
-    * @brief Returns the tool tip data.
+    * @brief Returns the tool tip data. Only the fields shown are read from the commit.
     *
-    * @param r The commit to generate the tooltip data.
+    * @param state The version of the history the row belongs to.
+    * @param row The row of the commit to generate the tooltip data.
     * @return QVariant The tool tip data.
     */
-   QVariant getToolTipData(const CommitInfo &r) const;
+   QVariant getToolTipData(const GitCache::RenderState &state, int row) const;
    /**
-    * @brief Returns the data that will be display for every \p column.
+    * @brief Returns the data that will be display for every \p column. Only the field of the column is read from the
+    * commit.
     *
-    * @param rev The commit info to retrieve the data that will be displayed.
+    * @param commits The commits of the version of the history the row belongs to.
+    * @param row The row of the commit.
     * @param column The column where the data will be shown.
     * @return QVariant The data to be shown.
     */
-   QVariant getDisplayData(const CommitInfo &rev, int column) const;
+   QVariant getDisplayData(const CommitPages &commits, int row, int column) const;
 };
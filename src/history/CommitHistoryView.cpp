@@ -39,11 +39,9 @@ CommitHistoryView::CommitHistoryView(const QSharedPointer<GitCache> &cache, cons
    connect(mCache.get(), &GitCache::signalCacheUpdated, this, &CommitHistoryView::refreshView);
 
    connect(this, &CommitHistoryView::doubleClicked, this, [this](const QModelIndex &index) {
-      if (mCommitHistoryModel)
-      {
-         const auto sha = mCommitHistoryModel->sha(index.row());
-         emit signalOpenDiff(sha);
-      }
+      // The index can belong to the filter so the SHA is taken from the model of the view.
+      const auto sha = model()->index(index.row(), static_cast<int>(CommitHistoryColumns::Sha)).data().toString();
+      emit signalOpenDiff(sha);
    });
 }
 
@@ -78,15 +76,31 @@ void CommitHistoryView::filterBySha(const QStringList &shaList)
    }
    else
    {
-      mProxyModel = new ShaFilterProxyModel(this);
-      mProxyModel->setSourceModel(mCommitHistoryModel);
+      mProxyModel = new ShaFilterProxyModel(mCache, this);
       mProxyModel->setAcceptedSha(shaList);
+      mProxyModel->setSourceModel(mCommitHistoryModel);
       setModel(mProxyModel);
    }
 
    setupGeometry();
 }
 
+void CommitHistoryView::clearFilter()
+{
+   mIsFiltering = false;
+
+   if (mProxyModel)
+   {
+      const auto oldSelectionModel = selectionModel();
+
+      setModel(mProxyModel->sourceModel());
+
+      delete oldSelectionModel;
+      delete mProxyModel;
+      mProxyModel = nullptr;
+   }
+}
+
 CommitHistoryView::~CommitHistoryView()
 {
    mSettings->setLocalValue(QString("%1").arg(objectName()), header()->saveState());
@@ -182,7 +196,8 @@ void CommitHistoryView::focusOnCommit(const QString &goToSha)
 
    QLog_Info("UI", QString("Setting the focus on the commit {%1}").arg(mCurrentSha));
 
-   auto row = mCache->commitInfo(mCurrentSha).pos;
+   // The commits that are not loaded focus the first row.
+   auto row = qMax(0, mCache->commitRow(mCurrentSha));
 
    if (mIsFiltering)
    {
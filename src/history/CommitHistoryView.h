@@ -144,6 +144,10 @@ public:
     * @return bool Returns true if the widget is actively filtering. Otherwise, false.
     */
    bool hasActiveFilter() const { return mIsFiltering; }
+   /**
+    * @brief Removes the filter and shows all the commits again.
+    */
+   void clearFilter();
 
    /**
     * @brief Clears any selection or data in the view.
@@ -167,6 +171,12 @@ public:
     * @return QModelIndexList The list of selected indexes.
     */
    QModelIndexList selectedIndexes() const override;
+   /**
+    * @brief Gets the model with the history, without the filter.
+    *
+    * @return CommitHistoryModel The history model.
+    */
+   CommitHistoryModel *historyModel() const { return mCommitHistoryModel; }
 
 private:
    QSharedPointer<GitCache> mCache;
@@ -0,0 +1,23 @@
+QT += widgets core network webenginewidgets webchannel testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = HistoryBenchmark
+
+# The benchmark paints the graph through the delegate of the history view, so it builds it with the rest of GitQlient.
+# It needs a display: it can be run with -platform offscreen.
+include($$PWD/../../App.pri)
+include($$PWD/../../../QLogger/QLogger.pri)
+
+INCLUDEPATH += $$PWD/../../../QLogger
+
+DEFINES += \
+    VER=\\\"0.0\\\" \
+    SHA_VER=\\\"0\\\" \
+    QT_NO_JAVA_STYLE_ITERATORS \
+    QT_DISABLE_DEPRECATED_BEFORE=0x050900 \
+    QT_USE_QSTRINGBUILDER
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,196 @@
+#include <CommitHistoryColumns.h>
+#include <CommitHistoryModel.h>
+#include <CommitHistoryView.h>
+#include <GitBase.h>
+#include <GitCache.h>
+#include <GitQlientSettings.h>
+#include <GitRepoLoader.h>
+#include <Lane.h>
+#include <RepositoryViewDelegate.h>
+
+#include <QImage>
+#include <QPainter>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace
+{
+// The synthetic history has LANES branches that grow at the same time from a common root, so with the date order all
+// of them are open in every row. Every MERGE_INTERVAL commits a branch merges the previous commit of the next one.
+const auto LANES = 32;
+const auto COMMITS_PER_LANE = 100;
+const auto MERGE_INTERVAL = 10;
+
+// The rows visible at the same time in a tall window.
+const auto VISIBLE_ROWS = 60;
+
+// The scale of a high DPI screen. Any transformation other than a translation paints the lanes with vectors.
+const auto FALLBACK_SCALE = 1.25;
+
+const auto LOAD_TIMEOUT = 60000;
+
+QByteArray syntheticHistory()
+{
+   QByteArray stream;
+   const auto commit = [&stream](int branch, int mark, qint64 time, const QByteArray &message) {
+      stream += "commit refs/heads/branch" + QByteArray::number(branch) + "\nmark :" + QByteArray::number(mark);
+      stream += "\ncommitter Benchmark <benchmark@example.com> " + QByteArray::number(time) + " +0000";
+      stream += "\ndata " + QByteArray::number(message.size()) + "\n" + message + "\n";
+   };
+   const auto markOf = [](int round, int branch) { return 2 + round * LANES + branch; };
+
+   auto time = Q_INT64_C(1600000000);
+
+   commit(0, 1, time, "Root");
+
+   for (auto round = 0; round < COMMITS_PER_LANE; ++round)
+   {
+      for (auto branch = 0; branch < LANES; ++branch)
+      {
+         commit(branch, markOf(round, branch), ++time,
+                QString("Commit %1 of the branch %2").arg(round).arg(branch).toUtf8());
+
+         stream += "from :" + QByteArray::number(round == 0 ? 1 : markOf(round - 1, branch)) + "\n";
+
+         if (round > 0 && round % MERGE_INTERVAL == 0)
+            stream += "merge :" + QByteArray::number(markOf(round - 1, (branch + 1) % LANES)) + "\n";
+
+         stream += "\n";
+      }
+   }
+
+   return stream;
+}
+}
+
+class HistoryBenchmark : public QObject
+{
+   Q_OBJECT
+
+private slots:
+   void initTestCase();
+   void cleanupTestCase();
+   void paintGraph_data();
+   void paintGraph();
+
+private:
+   QTemporaryDir mRepo;
+   QSharedPointer<GitBase> mGit;
+   QSharedPointer<GitCache> mCache;
+   QSharedPointer<GitQlientSettings> mSettings;
+   QSharedPointer<GitRepoLoader> mLoader;
+   CommitHistoryModel *mModel = nullptr;
+   CommitHistoryView *mView = nullptr;
+   RepositoryViewDelegate *mDelegate = nullptr;
+
+   bool git(const QStringList &arguments, const QByteArray &input = QByteArray()) const;
+};
+
+void HistoryBenchmark::initTestCase()
+{
+   // The settings of the user are not touched.
+   QStandardPaths::setTestModeEnabled(true);
+
+   QVERIFY(mRepo.isValid());
+   QVERIFY(git({ "init", "-q" }));
+   QVERIFY(git({ "fast-import", "--quiet" }, syntheticHistory()));
+   QVERIFY(git({ "symbolic-ref", "HEAD", "refs/heads/branch0" }));
+
+   mGit.reset(new GitBase(mRepo.path()));
+   mCache.reset(new GitCache());
+   mSettings.reset(new GitQlientSettings(mRepo.filePath(".git")));
+   mSettings->setLocalValue("GraphSortingOrder", 1);
+   mLoader.reset(new GitRepoLoader(mGit, mCache, mSettings));
+
+   QSignalSpy loaded(mLoader.get(), &GitRepoLoader::signalLoadingFinished);
+   mLoader->loadAll();
+
+   QVERIFY(loaded.count() == 1 || loaded.wait(LOAD_TIMEOUT));
+   QCOMPARE(mCache->commitCount(), LANES * COMMITS_PER_LANE + 2);
+
+   mModel = new CommitHistoryModel(mCache, mGit, nullptr);
+   mModel->onNewRevisions(mCache->commitCount());
+
+   mView = new CommitHistoryView(mCache, mGit, mSettings, nullptr);
+   mView->setModel(mModel);
+   mView->setItemDelegate(mDelegate = new RepositoryViewDelegate(mCache, nullptr, mView));
+
+   const auto state = mModel->renderState();
+   auto widestRow = 0;
+
+   for (auto row = 1; row < state->commits.count(); ++row)
+      widestRow = qMax(widestRow, mCache->lanes(*state, row).count());
+
+   qInfo("Synthetic graph: %d commits, up to %d lanes", state->commits.count() - 1, widestRow);
+
+   QVERIFY(widestRow >= 30);
+}
+
+void HistoryBenchmark::cleanupTestCase()
+{
+   delete mView;
+   delete mModel;
+}
+
+void HistoryBenchmark::paintGraph_data()
+{
+   QTest::addColumn<bool>("scaled");
+
+   QTest::newRow("glyph atlas") << false;
+   QTest::newRow("vector fallback") << true;
+}
+
+void HistoryBenchmark::paintGraph()
+{
+   QFETCH(bool, scaled);
+
+   // The delegate moves the graph 10 pixels to the right. The image is as big as the view would be on the screen.
+   const auto width = 10 + (LANES + 2) * LANE_WIDTH;
+   const auto scale = scaled ? FALLBACK_SCALE : 1.0;
+   QImage image(QSize(width, VISIBLE_ROWS * ROW_HEIGHT) * scale, QImage::Format_ARGB32_Premultiplied);
+
+   QStyleOptionViewItem option;
+   option.state = QStyle::State_Enabled;
+   option.font = mView->font();
+
+   const auto column = static_cast<int>(CommitHistoryColumns::Graph);
+   const auto rows = mModel->rowCount();
+
+   // Every iteration paints the whole history, a screen of rows after another.
+   QBENCHMARK
+   {
+      QPainter painter(&image);
+
+      if (scaled)
+         painter.scale(scale, scale);
+
+      for (auto row = 1; row < rows; ++row)
+      {
+         option.rect = QRect(0, (row % VISIBLE_ROWS) * ROW_HEIGHT, width, ROW_HEIGHT);
+         mDelegate->paint(&painter, option, mModel->index(row, column));
+      }
+   }
+}
+
+bool HistoryBenchmark::git(const QStringList &arguments, const QByteArray &input) const
+{
+   QProcess p;
+   p.setWorkingDirectory(mRepo.path());
+   p.start("git", arguments);
+   p.write(input);
+   p.closeWriteChannel();
+
+   if (!p.waitForFinished(LOAD_TIMEOUT) || p.exitCode() != 0)
+   {
+      qWarning("git %s failed: %s", qPrintable(arguments.join(' ')), p.readAllStandardError().constData());
+      return false;
+   }
+
+   return true;
+}
+
+QTEST_MAIN(HistoryBenchmark)
+
+#include "main.moc"
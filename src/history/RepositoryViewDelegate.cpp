@@ -5,7 +5,6 @@
 #include <CommitHistoryModel.h>
 #include <CommitHistoryView.h>
 #include <CommitInfo.h>
-#include <GitBase.h>
 #include <GitCache.h>
 #include <GitLocal.h>
 #include <GitQlientStyles.h>
@@ -14,29 +13,57 @@
 #include <LaneType.h>
 #include <PullRequest.h>
 
+#include <QAbstractProxyModel>
 #include <QApplication>
 #include <QClipboard>
 #include <QDesktopServices>
 #include <QEvent>
 #include <QPainter>
 #include <QPainterPath>
-#include <QSortFilterProxyModel>
 #include <QToolTip>
 #include <QUrl>
 
+#include <algorithm>
+#include <limits>
+
 using namespace GitServer;
 
 static const int MIN_VIEW_WIDTH_PX = 480;
+static const int LANE_PADDING = 2;
+// The glyphs are drawn from the padding to the end of the next lane plus the width of the pen.
+static const int LANE_GLYPH_WIDTH = LANE_WIDTH + 2 * LANE_PADDING;
+static const int MAX_LANE_GLYPHS = 4096;
+static const int MAX_ROW_DISPLAYS = 2048;
+
+bool RepositoryViewDelegate::LaneGlyphKey::operator==(const LaneGlyphKey &other) const
+{
+   return type == other.type && color == other.color && activeColor == other.activeColor
+       && mergeColor == other.mergeColor && laneHeadPresent == other.laneHeadPresent && isWip == other.isWip
+       && hasChilds == other.hasChilds && qFuzzyCompare(devicePixelRatio, other.devicePixelRatio);
+}
+
+uint qHash(const RepositoryViewDelegate::LaneGlyphKey &key, uint seed)
+{
+   const auto flags = (static_cast<uint>(key.type) << 3) | (key.laneHeadPresent ? 0x4u : 0u) | (key.isWip ? 0x2u : 0u)
+       | (key.hasChilds ? 0x1u : 0u);
+
+   return qHash(flags, seed) ^ qHash(key.color) ^ (qHash(key.activeColor) << 1) ^ (qHash(key.mergeColor) << 2)
+       ^ qHash(static_cast<int>(key.devicePixelRatio * 100));
+}
 
 RepositoryViewDelegate::RepositoryViewDelegate(const QSharedPointer<GitCache> &cache,
-                                               const QSharedPointer<GitBase> &git,
                                                const QSharedPointer<GitServerCache> &gitServerCache,
                                                CommitHistoryView *view)
    : mCache(cache)
-   , mGit(git)
    , mGitServerCache(gitServerCache)
    , mView(view)
+   , mBackgroundColor(GitQlientStyles::getBackgroundColor())
 {
+   // The styles can only change after a restart so the colors are read once instead of on every paint.
+   const auto colors = GitQlientStyles::getBranchColors();
+
+   for (const auto &color : colors)
+      mBranchColors.append(color);
 }
 
 void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index) const
@@ -52,21 +79,45 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
       p->fillRect(newOpt.rect, GitQlientStyles::getGraphHoverColor());
 
    const auto row = mView->hasActiveFilter()
-       ? dynamic_cast<QSortFilterProxyModel *>(mView->model())->mapToSource(index).row()
+       ? dynamic_cast<QAbstractProxyModel *>(mView->model())->mapToSource(index).row()
        : index.row();
 
-   const auto commit = mCache->commitInfo(row);
+   // The snapshot keeps the commit alive while it's painted without locking the cache. The rows are the ones of the
+   // version the model was updated with. Only the fields painted are read: the commit is not built.
+   const auto state = mView->historyModel()->renderState();
+   const auto &commits = state->commits;
 
-   if (commit.sha.isEmpty())
+   if (row < 0 || row >= commits.count())
       return;
 
+   // The row above is read first: looking up a row can invalidate the display data of another one.
+   auto previousDay = std::numeric_limits<qint64>::min();
+
+   if (index.column() == static_cast<int>(CommitHistoryColumns::Date))
+   {
+      if (const auto above = mView->indexAbove(index); above.isValid())
+      {
+         const auto aboveRow = mView->hasActiveFilter()
+             ? dynamic_cast<QAbstractProxyModel *>(mView->model())->mapToSource(above).row()
+             : above.row();
+
+         if (aboveRow >= 0 && aboveRow < commits.count())
+            previousDay = rowDisplay(commits, aboveRow).day;
+      }
+   }
+
+   auto &display = rowDisplay(commits, row);
+
    if (index.column() == static_cast<int>(CommitHistoryColumns::Graph))
    {
+      // The lanes are only calculated for the rows painted. The filtered view doesn't draw them.
+      const auto lanes = mView->hasActiveFilter() ? QVector<Lane>() : mCache->lanes(*state, row);
+
       newOpt.rect.setX(newOpt.rect.x() + 10);
-      paintGraph(p, newOpt, commit);
+      paintGraph(p, newOpt, commits, row, lanes);
    }
    else if (index.column() == static_cast<int>(CommitHistoryColumns::Log))
-      paintLog(p, newOpt, commit, index.data().toString());
+      paintLog(p, newOpt, display);
    else
    {
 
@@ -74,18 +125,12 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
       newOpt.rect.setX(newOpt.rect.x() + 10);
 
       QTextOption textalignment(Qt::AlignLeft | Qt::AlignVCenter);
-      auto text = index.data().toString();
+      QString text;
 
       if (index.column() == static_cast<int>(CommitHistoryColumns::Date))
       {
          textalignment = QTextOption(Qt::AlignRight | Qt::AlignVCenter);
-         const auto prev = QDateTime::fromString(mView->indexAbove(index).data().toString(), "dd MMM yyyy hh:mm");
-         const auto current = QDateTime::fromString(text, "dd MMM yyyy hh:mm");
-
-         if (current.date() == prev.date())
-            text = current.toString("hh:mm");
-         else
-            text = current.toString("dd MMM yyyy - hh:mm");
+         text = display.day == previousDay ? display.time : display.dateTime;
 
          newOpt.rect.setWidth(newOpt.rect.width() - 5);
       }
@@ -94,23 +139,27 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
          newOpt.font.setPointSize(8);
          newOpt.font.setFamily("DejaVu Sans Mono");
 
-         text = commit.sha != CommitInfo::ZERO_SHA ? text.left(8) : "";
+         text = display.shortSha;
       }
-      else if (index.column() == static_cast<int>(CommitHistoryColumns::Author) && commit.isSigned())
+      else if (index.column() == static_cast<int>(CommitHistoryColumns::Author))
       {
-         static const auto size = 15;
-         static const auto offset = 5;
-         QPixmap pic(QString::fromUtf8(commit.verifiedSignature() ? ":/icons/signed" : ":/icons/unsigned"));
-         pic = pic.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+         text = display.author;
+
+         if (commits.isSigned(row))
+         {
+            static const auto size = 15;
+            static const auto offset = 5;
+            QPixmap pic(QString::fromUtf8(commits.verifiedSignature(row) ? ":/icons/signed" : ":/icons/unsigned"));
+            pic = pic.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
 
-         const auto inc = (newOpt.rect.height() - size) / 2;
+            const auto inc = (newOpt.rect.height() - size) / 2;
 
-         p->drawPixmap(QRect(newOpt.rect.x(), newOpt.rect.y() + inc, size, size), pic);
+            p->drawPixmap(QRect(newOpt.rect.x(), newOpt.rect.y() + inc, size, size), pic);
 
-         newOpt.rect.setX(newOpt.rect.x() + size + offset);
+            newOpt.rect.setX(newOpt.rect.x() + size + offset);
+         }
       }
 
-      QFontMetrics fm(newOpt.font);
       p->setFont(newOpt.font);
 
       if (const auto cursorColumn = mView->indexAt(mView->mapFromGlobal(QCursor::pos())).column();
@@ -120,10 +169,53 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
          p->setPen(gitQlientOrange);
       }
 
-      p->drawText(newOpt.rect, fm.elidedText(text, Qt::ElideRight, newOpt.rect.width()), textalignment);
+      p->drawText(newOpt.rect, elidedText(display, index.column(), text, newOpt.font, newOpt.rect.width()),
+                  textalignment);
    }
 }
 
+RepositoryViewDelegate::RowDisplay &RepositoryViewDelegate::rowDisplay(const CommitPages &commits, int row) const
+{
+   const auto oid = commits.oid(row);
+   const auto secsSinceEpoch = commits.date(row);
+
+   // The date of the WIP changes every time it's updated.
+   if (const auto iter = mRowDisplays.find(oid); iter != mRowDisplays.end() && iter->secsSinceEpoch == secsSinceEpoch)
+      return *iter;
+
+   if (mRowDisplays.count() >= MAX_ROW_DISPLAYS)
+      mRowDisplays.clear();
+
+   const auto date = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
+
+   RowDisplay display;
+   display.secsSinceEpoch = secsSinceEpoch;
+   display.day = date.date().toJulianDay();
+   display.time = date.toString("hh:mm");
+   display.dateTime = date.toString("dd MMM yyyy - hh:mm");
+   display.sha = oid.toSha();
+   display.shortSha = row != 0 ? display.sha.left(8) : QString();
+   display.author = commits.author(row).section('<', 0, 0);
+   display.shortLog = commits.shortLog(row);
+
+   return *mRowDisplays.insert(oid, display);
+}
+
+QString RepositoryViewDelegate::elidedText(RowDisplay &display, int column, const QString &text, const QFont &font,
+                                           int width) const
+{
+   auto &elided = display.elided[column];
+
+   if (elided.width != width || elided.text != text)
+   {
+      elided.text = text;
+      elided.width = width;
+      elided.elided = QFontMetrics(font).elidedText(text, Qt::ElideRight, width);
+   }
+
+   return elided.elided;
+}
+
 QSize RepositoryViewDelegate::sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const
 {
    return QSize(LANE_WIDTH, ROW_HEIGHT);
@@ -160,9 +252,8 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
                                             const QColor &col, const QColor &activeCol, const QColor &mergeColor,
                                             bool isWip, bool hasChilds) const
 {
-   const auto padding = 2;
-   x1 += padding;
-   x2 += padding;
+   x1 += LANE_PADDING;
+   x2 += LANE_PADDING;
 
    const auto h = ROW_HEIGHT / 2;
    const auto m = (x1 + x2) / 2;
@@ -173,7 +264,7 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
    const auto angleHeightUp = 2 * h;
    const auto angleHeightDown = 2 * -h;
 
-   static QPen lanePen(GitQlientStyles::getTextColor(), 2); // fast path here
+   QPen lanePen(col, 2);
 
    // arc
    lanePen.setBrush(col);
@@ -278,7 +369,7 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
          case LaneType::ACTIVE: {
             isCommit = true;
             p->setPen(QPen(col, 2));
-            p->setBrush(QColor(isWip ? col : GitQlientStyles::getBackgroundColor()));
+            p->setBrush(isWip ? col : mBackgroundColor);
             p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
          }
          break;
@@ -314,11 +405,62 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
    }
 }
 
-QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
+void RepositoryViewDelegate::paintCachedLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1,
+                                             const QColor &col, const QColor &activeCol, const QColor &mergeColor,
+                                             bool isWip, bool hasChilds) const
+{
+   if (p->transform().type() > QTransform::TxTranslate)
+   {
+      paintGraphLane(p, lane, laneHeadPresent, x1, x1 + LANE_WIDTH, col, activeCol, mergeColor, isWip, hasChilds);
+      return;
+   }
+
+   const auto devicePixelRatio = p->device()->devicePixelRatioF();
+
+   // The values that don't change the result are left out of the key so more lanes share the same glyph.
+   const LaneGlyphKey key { lane.getType(),
+                            col.rgba(),
+                            isWip ? activeCol.rgba() : 0u,
+                            mergeColor.rgba(),
+                            lane.getType() == LaneType::MERGE_FORK_L && laneHeadPresent,
+                            isWip,
+                            hasChilds,
+                            devicePixelRatio };
+
+   auto glyph = mLaneGlyphs.value(key);
+
+   if (glyph.isNull())
+   {
+      if (mLaneGlyphs.count() >= MAX_LANE_GLYPHS)
+         mLaneGlyphs.clear();
+
+      glyph = QPixmap(QSize(LANE_GLYPH_WIDTH, ROW_HEIGHT) * devicePixelRatio);
+      glyph.setDevicePixelRatio(devicePixelRatio);
+      glyph.fill(Qt::transparent);
+
+      QPainter glyphPainter(&glyph);
+      glyphPainter.setRenderHints(QPainter::Antialiasing);
+
+      paintGraphLane(&glyphPainter, lane, laneHeadPresent, 0, LANE_WIDTH, col, activeCol, mergeColor, isWip,
+                     hasChilds);
+
+      glyphPainter.end();
+
+      mLaneGlyphs.insert(key, glyph);
+   }
+
+   p->drawPixmap(x1, 0, glyph);
+}
+
+const QColor &RepositoryViewDelegate::branchColorAt(int laneIndex) const
+{
+   return mBranchColors.at(laneIndex % mBranchColors.count());
+}
+
+QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const QVector<Lane> &lanes, int currentLaneIndex,
                                              const QColor &defaultColor, bool &isSet) const
 {
    auto mergeColor = defaultColor;
-   //= GitQlientStyles::getBranchColorAt((commit.getLanesCount() - 1) % GitQlientStyles::getTotalBranchColors());
 
    switch (currentLane.getType())
    {
@@ -335,9 +477,9 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
       case LaneType::JOIN_L:
          for (auto laneCount = 0; laneCount < currentLaneIndex; ++laneCount)
          {
-            if (commit.laneAt(laneCount).equals(LaneType::JOIN_L))
+            if (lanes.at(laneCount).equals(LaneType::JOIN_L))
             {
-               mergeColor = GitQlientStyles::getBranchColorAt(laneCount % GitQlientStyles::getTotalBranchColors());
+               mergeColor = branchColorAt(laneCount);
                isSet = true;
                break;
             }
@@ -350,51 +492,55 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
    return mergeColor;
 }
 
-void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit) const
+void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const CommitPages &commits,
+                                        int row, const QVector<Lane> &lanes) const
 {
+   const auto hasChilds = commits.hasChilds(row);
+
    p->save();
    p->setClipRect(opt.rect, Qt::IntersectClip);
    p->translate(opt.rect.topLeft());
 
    if (mView->hasActiveFilter())
    {
-      const auto activeColor = GitQlientStyles::getBranchColorAt(0);
-      paintGraphLane(p, LaneType::ACTIVE, false, 0, LANE_WIDTH, activeColor, activeColor, activeColor, false,
-                     commit.hasChilds());
+      const auto activeColor = branchColorAt(0);
+      paintCachedLane(p, LaneType::ACTIVE, false, 0, activeColor, activeColor, activeColor, false, hasChilds);
    }
    else
    {
-      if (commit.sha == CommitInfo::ZERO_SHA)
+      // The WIP is always the first row.
+      if (row == 0)
       {
-         const auto activeColor = GitQlientStyles::getBranchColorAt(0);
+         const auto activeColor = branchColorAt(0);
          QColor color = activeColor;
 
-         if (mCache->pendingLocalChanges())
+         if (mCache->renderState()->pendingLocalChanges)
             color = gitQlientOrange;
 
-         paintGraphLane(p, LaneType::BRANCH, false, 0, LANE_WIDTH, color, activeColor, activeColor, true,
-                        commit.parentsCount() != 0);
+         paintCachedLane(p, LaneType::BRANCH, false, 0, color, activeColor, activeColor, true,
+                         commits.parentsCount(row) != 0);
       }
       else
       {
-         const auto laneNum = commit.lanesCount();
-         const auto activeLane = commit.getActiveLane();
-         const auto activeColor
-             = GitQlientStyles::getBranchColorAt(activeLane % GitQlientStyles::getTotalBranchColors());
+         const auto laneNum = lanes.count();
+         const auto active
+             = std::find_if(lanes.cbegin(), lanes.cend(), [](const Lane &lane) { return lane.isActive(); });
+         const auto activeLane = static_cast<int>(std::distance(lanes.cbegin(), active));
+         const auto activeColor = branchColorAt(activeLane);
          auto x1 = 0;
          auto isSet = false;
          auto laneHeadPresent = false;
-         auto mergeColor = GitQlientStyles::getBranchColorAt((laneNum - 1) % GitQlientStyles::getTotalBranchColors());
+         auto mergeColor = branchColorAt(laneNum - 1);
 
          for (auto i = laneNum - 1, x2 = LANE_WIDTH * laneNum; i >= 0; --i, x2 -= LANE_WIDTH)
          {
             x1 = x2 - LANE_WIDTH;
 
-            auto currentLane = commit.laneAt(i);
+            const auto &currentLane = lanes.at(i);
 
             if (!laneHeadPresent && i < laneNum - 1)
             {
-               auto prevLane = commit.laneAt(i + 1);
+               const auto &prevLane = lanes.at(i + 1);
                laneHeadPresent
                    = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
             }
@@ -404,13 +550,13 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
                auto color = activeColor;
 
                if (i != activeLane)
-                  color = GitQlientStyles::getBranchColorAt(i % GitQlientStyles::getTotalBranchColors());
+                  color = branchColorAt(i);
 
                if (!isSet)
-                  mergeColor = getMergeColor(currentLane, commit, i, color, isSet);
+                  mergeColor = getMergeColor(currentLane, lanes, i, color, isSet);
 
-               paintGraphLane(p, currentLane, laneHeadPresent, x1, x2, color, activeColor, mergeColor, false,
-                              commit.hasChilds());
+               paintCachedLane(p, currentLane, laneHeadPresent, x1, color, activeColor, mergeColor, false,
+                               hasChilds);
 
                if (mView->hasActiveFilter())
                   break;
@@ -421,19 +567,14 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
    p->restore();
 }
 
-void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit,
-                                      const QString &text) const
+void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, RowDisplay &display) const
 {
-   const auto sha = commit.sha;
-
-   if (sha.isEmpty())
-      return;
-
+   const auto &sha = display.sha;
    auto offset = 0;
 
    if (mGitServerCache)
    {
-      if (const auto pr = mGitServerCache->getPullRequest(commit.sha); pr.isValid())
+      if (const auto pr = mGitServerCache->getPullRequest(sha); pr.isValid())
       {
          offset = 5;
          paintPrStatus(p, opt, offset, pr);
@@ -445,36 +586,36 @@ void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &o
    auto newOpt = opt;
    newOpt.rect.setX(opt.rect.x() + offset + 5);
 
-   QFontMetrics fm(newOpt.font);
-
    p->setFont(newOpt.font);
    p->setPen(GitQlientStyles::getTextColor());
-   p->drawText(newOpt.rect, fm.elidedText(text, Qt::ElideRight, newOpt.rect.width()),
+   p->drawText(newOpt.rect,
+               elidedText(display, static_cast<int>(CommitHistoryColumns::Log), display.shortLog, newOpt.font,
+                          newOpt.rect.width()),
                QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
 }
 
 void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewItem o, int &startPoint,
                                             const QString &sha) const
 {
-   if (mCache->hasReferences(sha) && !mView->hasActiveFilter())
+   const auto state = mCache->renderState();
+   const auto references = state->references.constFind(sha);
+
+   if (references != state->references.cend() && !references->isEmpty() && !mView->hasActiveFilter())
    {
       QVector<QString> marks;
       QVector<QColor> colors;
-      const auto currentBranch = mGit->getCurrentBranch();
+      const auto &currentBranch = state->currentBranch;
 
       if (startPoint == 0)
          startPoint = 5;
 
-      if ((currentBranch.isEmpty() || currentBranch == "HEAD"))
+      if (state->detached && sha == state->headSha)
       {
-         if (const auto ret = mGit->getLastCommit(); ret.success && sha == ret.output.trimmed())
-         {
-            marks.append("detached");
-            colors.append(graphDetached);
-         }
+         marks.append("detached");
+         colors.append(graphDetached);
       }
 
-      const auto localBranches = mCache->getReferences(sha, References::Type::LocalBranch);
+      const auto localBranches = references->getReferences(References::Type::LocalBranch);
       for (const auto &branch : localBranches)
       {
          if (branch == currentBranch)
@@ -489,14 +630,14 @@ void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewI
          }
       }
 
-      const auto tags = mCache->getReferences(sha, References::Type::LocalTag);
+      const auto tags = references->getReferences(References::Type::LocalTag);
       for (const auto &tag : tags)
       {
          marks.append(tag);
          colors.append(graphTag);
       }
 
-      const auto remoteBranches = mCache->getReferences(sha, References::Type::RemoteBranches);
+      const auto remoteBranches = references->getReferences(References::Type::RemoteBranches);
       for (const auto &branch : remoteBranches)
       {
          marks.append(branch);
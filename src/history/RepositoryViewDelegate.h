@@ -23,14 +23,19 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ObjectId.h>
+
 #include <QStyledItemDelegate>
 #include <QDateTime>
+#include <QHash>
+#include <QPixmap>
+#include <QVector>
 
 class CommitHistoryView;
 class GitCache;
-class GitBase;
 class Lane;
-class CommitInfo;
+enum class LaneType : quint8;
+class CommitPages;
 class GitServerCache;
 
 namespace GitServer
@@ -56,11 +61,11 @@ public:
     * @brief Default constructor.
     *
     * @param cache The cache for the current repository.
-    * @param git The git object to execute git commands.
+    * @param gitServerCache The cache of the Git server, if any.
     * @param view The view that uses the delegate.
     */
-   RepositoryViewDelegate(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git,
-                          const QSharedPointer<GitServerCache> &gitServerCache, CommitHistoryView *view);
+   RepositoryViewDelegate(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitServerCache> &gitServerCache,
+                          CommitHistoryView *view);
 
    /**
     * @brief Overridden method to paint the different columns and rows in the view.
@@ -82,12 +87,84 @@ protected:
                     const QModelIndex &index) override;
 
 private:
+   /**
+    * @brief The LaneGlyphKey struct identifies a pre-rendered lane: everything that changes how a lane is painted.
+    */
+   struct LaneGlyphKey
+   {
+      LaneType type;
+      QRgb color;
+      QRgb activeColor;
+      QRgb mergeColor;
+      bool laneHeadPresent;
+      bool isWip;
+      bool hasChilds;
+      qreal devicePixelRatio;
+
+      bool operator==(const LaneGlyphKey &other) const;
+   };
+
+   friend uint qHash(const LaneGlyphKey &key, uint seed);
+
+   /**
+    * @brief The ElidedText struct stores the text painted in a column once elided for the width it was painted with.
+    */
+   struct ElidedText
+   {
+      QString text;
+      int width = -1;
+      QString elided;
+   };
+
+   /**
+    * @brief The RowDisplay struct contains the text of a commit already formatted for the view, so scrolling doesn't
+    * format nor elide the same strings again.
+    */
+   struct RowDisplay
+   {
+      qint64 secsSinceEpoch = 0;
+      qint64 day = 0;
+      QString time;
+      QString dateTime;
+      QString sha;
+      QString shortSha;
+      QString author;
+      QString shortLog;
+      QHash<int, ElidedText> elided;
+   };
+
    QSharedPointer<GitCache> mCache;
-   QSharedPointer<GitBase> mGit;
    QSharedPointer<GitServerCache> mGitServerCache;
    CommitHistoryView *mView = nullptr;
    int diffTargetRow = -1;
    int mColumnPressed = -1;
+   QVector<QColor> mBranchColors;
+   QColor mBackgroundColor;
+   mutable QHash<LaneGlyphKey, QPixmap> mLaneGlyphs;
+   mutable QHash<ObjectId, RowDisplay> mRowDisplays;
+
+   /**
+    * @brief Returns the display data of the commit, formatting it the first time the commit is painted. Only the
+    * fields shown are read from the commit.
+    *
+    * @param commits The commits of the version of the history painted.
+    * @param row The row of the commit.
+    * @return The display data. It's only valid until the next call.
+    */
+   RowDisplay &rowDisplay(const CommitPages &commits, int row) const;
+
+   /**
+    * @brief Returns the text elided to fit in the given width. The last elided text of every column is kept so it's
+    * only calculated again when the text or the width change.
+    *
+    * @param display The display data of the row.
+    * @param column The column painted.
+    * @param text The text to elide.
+    * @param font The font used to paint the text.
+    * @param width The width available.
+    * @return The elided text.
+    */
+   QString elidedText(RowDisplay &display, int column, const QString &text, const QFont &font, int width) const;
 
    /**
     * @brief Paints the log column. This method is in charge of painting the commit message as well as tags or
@@ -95,17 +172,20 @@ private:
     *
     * @param p The painter device.
     * @param o The style options of the item.
-    * @param i The index with the item data.
+    * @param display The display data of the row.
     */
-   void paintLog(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit, const QString &text) const;
+   void paintLog(QPainter *p, const QStyleOptionViewItem &o, RowDisplay &display) const;
    /**
     * @brief Method that sets up the configuration to paint the lane for the commit graph representation.
     *
     * @param p The painter device.
     * @param o The style options of the item.
-    * @param index The index with the item data.
+    * @param commits The commits of the version of the history painted.
+    * @param row The row of the commit.
+    * @param lanes The lanes of the graph in the row.
     */
-   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit) const;
+   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const CommitPages &commits, int row,
+                   const QVector<Lane> &lanes) const;
 
    /**
     * @brief Specialization method called by @ref paintGrapth that does the actual lane painting.
@@ -124,6 +204,21 @@ private:
                        const QColor &activeCol, const QColor &mergeColor, bool isWip = false,
                        bool hasChilds = true) const;
 
+   /**
+    * @brief Paints a lane copying a pre-rendered glyph. The glyph is rendered with @ref paintGraphLane the first time
+    * it's needed. If the painter transformation is not a translation, the lane is painted directly.
+    *
+    * The parameters are the same as in @ref paintGraphLane.
+    */
+   void paintCachedLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, const QColor &col,
+                        const QColor &activeCol, const QColor &mergeColor, bool isWip = false,
+                        bool hasChilds = true) const;
+
+   /**
+    * @brief Gets the color of the lane in the given position.
+    */
+   const QColor &branchColorAt(int laneIndex) const;
+
    /**
     * @brief Specialized method that paints a tag in the commit message column.
     *
@@ -149,13 +244,13 @@ private:
     * @brief getMergeColor Returns the color to be used for painting the external circle of the node. This methods
     * searches the origin of the merge and uses the same lane color.
     * @param currentLane The current lane type.
-    * @param commit The current commit.
+    * @param lanes The lanes of the current row.
     * @param currentLaneIndex The current index of the lane.
     * @param defaultColor The default color in case it's not a merge.
     * @param isSet Boolean used as a shortcut. If the current iteration is a merge it will change the value for the
     * following lanes.
     * @return Returns the color of the lane that merges into the current node, otherwise it returns @p defaultColor.
     */
-   QColor getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
+   QColor getMergeColor(const Lane &currentLane, const QVector<Lane> &lanes, int currentLaneIndex,
                         const QColor &defaultColor, bool &isSet) const;
 };
@@ -1,15 +1,172 @@
 #include "ShaFilterProxyModel.h"
 
-#include <CommitHistoryColumns.h>
+#include <CommitHistoryModel.h>
+#include <GitCache.h>
 
-ShaFilterProxyModel::ShaFilterProxyModel(QObject *parent)
-   : QSortFilterProxyModel(parent)
+#include <algorithm>
+
+ShaFilterProxyModel::ShaFilterProxyModel(const QSharedPointer<GitCache> &cache, QObject *parent)
+   : QAbstractProxyModel(parent)
+   , mCache(cache)
+{
+}
+
+void ShaFilterProxyModel::setAcceptedSha(const QStringList &acceptedShaList)
+{
+   mAcceptedShas = acceptedShaList;
+}
+
+void ShaFilterProxyModel::endResetModel()
+{
+   setRows(acceptedRows());
+   QAbstractProxyModel::endResetModel();
+}
+
+void ShaFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+   if (const auto oldModel = this->sourceModel())
+      disconnect(oldModel, nullptr, this, nullptr);
+
+   beginResetModel();
+   QAbstractProxyModel::setSourceModel(sourceModel);
+   endResetModel();
+
+   if (!sourceModel)
+      return;
+
+   connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, [this]() { beginResetModel(); });
+   connect(sourceModel, &QAbstractItemModel::modelReset, this, [this]() { endResetModel(); });
+   connect(sourceModel, &QAbstractItemModel::rowsInserted, this,
+           [this](const QModelIndex &, int first, int last) { onRowsInserted(first, last); });
+   connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+           [this](const QModelIndex &, int first, int last) { onRowsAboutToBeRemoved(first, last); });
+   connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, [this]() { onRowsRemoved(); });
+   connect(sourceModel, &QAbstractItemModel::dataChanged, this, [this]() {
+      if (!mRows.isEmpty())
+         emit dataChanged(index(0, 0), index(mRows.count() - 1, columnCount() - 1));
+   });
+}
+
+QModelIndex ShaFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+   if (!sourceModel() || !proxyIndex.isValid() || proxyIndex.row() >= mRows.count())
+      return QModelIndex();
+
+   return sourceModel()->index(mRows.at(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex ShaFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+   if (!sourceIndex.isValid() || sourceIndex.row() >= mProxyRows.count())
+      return QModelIndex();
+
+   const auto row = mProxyRows.at(sourceIndex.row());
+
+   return row != -1 ? createIndex(row, sourceIndex.column()) : QModelIndex();
+}
+
+QModelIndex ShaFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+   if (parent.isValid() || row < 0 || row >= mRows.count() || column < 0 || column >= columnCount())
+      return QModelIndex();
+
+   return createIndex(row, column);
+}
+
+QModelIndex ShaFilterProxyModel::parent(const QModelIndex &) const
 {
+   return QModelIndex();
 }
 
-bool ShaFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+int ShaFilterProxyModel::rowCount(const QModelIndex &parent) const
 {
-   const auto shaIndex = sourceModel()->index(sourceRow, static_cast<int>(CommitHistoryColumns::Sha), sourceParent);
-   const auto sha = sourceModel()->data(shaIndex).toString();
-   return mAcceptedShas.contains(sha);
+   return !parent.isValid() ? mRows.count() : 0;
+}
+
+int ShaFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+   return sourceModel() && !parent.isValid() ? sourceModel()->columnCount(QModelIndex()) : 0;
+}
+
+QVector<int> ShaFilterProxyModel::acceptedRows() const
+{
+   const auto historyModel = qobject_cast<CommitHistoryModel *>(sourceModel());
+
+   if (!historyModel)
+      return {};
+
+   // The cache can be ahead of the model: the rows are taken from the version of the history the model shows.
+   const auto sourceRows = historyModel->rowCount();
+   auto rows = mCache->commitRows(mAcceptedShas, historyModel->renderState()->rowShift);
+
+   rows.erase(std::lower_bound(rows.begin(), rows.end(), sourceRows), rows.end());
+
+   return rows;
+}
+
+void ShaFilterProxyModel::setRows(QVector<int> rows)
+{
+   mRows = std::move(rows);
+   mProxyRows.fill(-1, sourceModel() ? sourceModel()->rowCount() : 0);
+
+   for (auto row = 0; row < mRows.count(); ++row)
+      mProxyRows[mRows.at(row)] = row;
+}
+
+void ShaFilterProxyModel::onRowsInserted(int first, int last)
+{
+   // The rows already shown move down and the accepted ones among the new rows are inserted in a single block.
+   const auto count = last - first + 1;
+   const auto rows = acceptedRows();
+   const auto position = static_cast<int>(std::lower_bound(mRows.cbegin(), mRows.cend(), first) - mRows.cbegin());
+   const auto insertedBegin = std::lower_bound(rows.cbegin(), rows.cend(), first);
+   const auto insertedEnd = std::upper_bound(insertedBegin, rows.cend(), last);
+   const auto inserted = static_cast<int>(insertedEnd - insertedBegin);
+
+   auto expected = mRows;
+
+   for (auto i = position; i < expected.count(); ++i)
+      expected[i] += count;
+
+   expected.insert(position, inserted, 0);
+   std::copy(insertedBegin, insertedEnd, expected.begin() + position);
+
+   // Any other difference means the accepted SHAs moved in a way the insertion doesn't explain.
+   if (expected != rows)
+   {
+      QAbstractProxyModel::beginResetModel();
+      setRows(rows);
+      QAbstractProxyModel::endResetModel();
+   }
+   else if (inserted > 0)
+   {
+      beginInsertRows(QModelIndex(), position, position + inserted - 1);
+      setRows(rows);
+      endInsertRows();
+   }
+   else
+      setRows(rows);
+}
+
+void ShaFilterProxyModel::onRowsAboutToBeRemoved(int first, int last)
+{
+   const auto begin = std::lower_bound(mRows.cbegin(), mRows.cend(), first);
+   const auto end = std::upper_bound(mRows.cbegin(), mRows.cend(), last);
+
+   if (begin != end)
+   {
+      mRemovedRows = qMakePair(static_cast<int>(begin - mRows.cbegin()), static_cast<int>(end - mRows.cbegin()) - 1);
+      beginRemoveRows(QModelIndex(), mRemovedRows.first, mRemovedRows.second);
+   }
+}
+
+void ShaFilterProxyModel::onRowsRemoved()
+{
+   setRows(acceptedRows());
+
+   if (mRemovedRows.first != -1)
+   {
+      mRemovedRows = qMakePair(-1, -1);
+      endRemoveRows();
+   }
 }
@@ -23,14 +23,22 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QSortFilterProxyModel>
+#include <QAbstractProxyModel>
+#include <QPair>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+class GitCache;
 
 /**
- * @brief The ShaFilterProxyModel class is an overload of the QSortFilterProxyModel that takes a list of shas to act as
- * a filter between a view and a QAbstractiItemModel.
+ * @brief The ShaFilterProxyModel class is a proxy model that takes a list of SHAs to act as a filter between a view and
+ * the history model. The rows of the SHAs are taken from the cache, in the version of the history the model shows, and
+ * kept in both directions, so the indexes are mapped without reading the data of the source model. The rows inserted
+ * and removed in the source model are forwarded, so the selection of the view is kept.
  *
  */
-class ShaFilterProxyModel : public QSortFilterProxyModel
+class ShaFilterProxyModel : public QAbstractProxyModel
 {
    Q_OBJECT
 
@@ -38,41 +46,63 @@ public:
    /**
     * @brief Default constructor.
     *
+    * @param cache The cache of the repository, whose rows are the ones of the source model.
     * @param parent The parent widget if needed.
     */
-   explicit ShaFilterProxyModel(QObject *parent = nullptr);
+   explicit ShaFilterProxyModel(const QSharedPointer<GitCache> &cache, QObject *parent = nullptr);
 
    /**
-    * @brief Sets the list of accepted SHAs that will be shown in the source model.
+    * @brief Sets the list of accepted SHAs that will be shown in the source model. The rows are mapped when the reset
+    * of the model ends.
     *
     * @param acceptedShaList The SHAs list.
     */
-   void setAcceptedSha(const QStringList &acceptedShaList) { mAcceptedShas = acceptedShaList; }
+   void setAcceptedSha(const QStringList &acceptedShaList);
    /**
     * @brief Starts the reset of the model
     *
     */
-   void beginResetModel() { QSortFilterProxyModel::beginResetModel(); }
+   void beginResetModel() { QAbstractProxyModel::beginResetModel(); }
    /**
-    * @brief Ends the reset of the model.
+    * @brief Maps the rows of the accepted SHAs again and ends the reset of the model.
     *
     */
-   void endResetModel() { QSortFilterProxyModel::endResetModel(); }
+   void endResetModel();
+
+   void setSourceModel(QAbstractItemModel *sourceModel) override;
+   QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+   QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex parent(const QModelIndex &index) const override;
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
-protected:
+private:
+   QSharedPointer<GitCache> mCache;
+   QStringList mAcceptedShas;
    /**
-    * @brief This method is the actual filter functionality. Given the source row and the source index it retrieves the
-    * sha and checks if it's among the accepted SHAs in the list.
-    *
-    * @param sourceRow The source row number.
-    * @param sourceParent The source index.
-    * @return bool Returns true if the source row should be shown in the view.
+    * @brief mRows The rows of the source model shown, from top to bottom.
+    */
+   QVector<int> mRows;
+   /**
+    * @brief mProxyRows The row in the proxy of every row of the source model, or -1 if it's filtered out.
     */
-   bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+   QVector<int> mProxyRows;
 
-private:
    /**
-    * @brief mAcceptedShas List of accepted shas.
+    * @brief mRemovedRows The first and last rows of the proxy being removed, or -1 if none.
     */
-   QStringList mAcceptedShas;
+   QPair<int, int> mRemovedRows { -1, -1 };
+
+   /**
+    * @brief Returns the rows of the source model of the accepted SHAs, from top to bottom.
+    */
+   QVector<int> acceptedRows() const;
+   /**
+    * @brief Maps the rows of the source model @p rows in both directions.
+    */
+   void setRows(QVector<int> rows);
+   void onRowsInserted(int first, int last);
+   void onRowsAboutToBeRemoved(int first, int last);
+   void onRowsRemoved();
 };